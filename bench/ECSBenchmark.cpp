@@ -0,0 +1,290 @@
+// Standalone ECS storage benchmark: no SDL, prints JSON.
+//
+//   ECSBenchmark [--entities 1000,10000,...] [--types 1,4,16] [--repeat n]
+//                [--max-components n] [--seed n] [--out file.json]
+//
+// For every (entities, component types) pair a fresh world is filled and each storage
+// operation is timed as one batch. With --repeat the fastest batch is kept.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../lib/ECS.h"
+#include "../lib/MemoryStats.h"
+
+namespace {
+
+constexpr size_t kMaxTypes = 16;
+
+// 16 distinct component types of the size of a typical small POD component
+template<size_t N>
+struct BenchComponent {
+    float value[4];
+};
+
+// calls f(std::integral_constant<size_t, I>) for the first count component types
+template<typename F, size_t... I>
+void forTypes(const size_t count, F&& f, std::index_sequence<I...>) {
+    ((I < count ? f(std::integral_constant<size_t, I>{}) : void()), ...);
+}
+
+template<typename F>
+void forTypes(const size_t count, F&& f) {
+    forTypes(count, std::forward<F>(f), std::make_index_sequence<kMaxTypes>{});
+}
+
+enum Op {
+    CreateEntity,
+    AddComponent,
+    GetComponentSequential,
+    GetComponentRandom,
+    IterateGetEntitiesWith,
+    RemoveComponent,
+    DestroyEntity,
+    kOpCount
+};
+
+const char* const kOpNames[kOpCount] = {
+    "createEntity", "addComponent", "getComponentSequential", "getComponentRandom",
+    "getEntitiesWith", "removeComponent", "destroyEntity"
+};
+
+struct Measurement {
+    size_t ops = 0;
+    double seconds = 0.0;
+};
+
+struct Result {
+    size_t entities = 0;
+    size_t types = 0;
+    bool skipped = false;
+    Measurement ops[kOpCount];
+    double ecsBytesPerEntity = 0.0;
+    double rssBytesPerEntity = 0.0;
+};
+
+struct Options {
+    std::vector<size_t> entities{1000, 10000, 100000, 1000000, 10000000};
+    std::vector<size_t> types{1, 4, 16};
+    size_t repeat = 1;
+    size_t maxComponents = 40000000; // entities * types above this are skipped (~30 bytes each)
+    uint32_t seed = 12345;
+    const char* out = nullptr;
+};
+
+// keeps reads from being optimised away
+volatile float sink = 0.0f;
+
+using Clock = std::chrono::steady_clock;
+
+template<typename F>
+double timeIt(F&& f) {
+    const auto start = Clock::now();
+    f();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void keepFastest(Measurement& best, const size_t ops, const double seconds) {
+    if (best.ops == 0 || seconds < best.seconds)
+        best = {ops, seconds};
+}
+
+void runOnce(Result& result, const std::vector<EntityID>& shuffled, std::vector<EntityID>& ids, const bool sampleMemory) {
+    const size_t n = result.entities;
+    const size_t types = result.types;
+    ECSWorld world;
+    ids.clear();
+    const size_t rssBefore = getMemoryBytes();
+
+    keepFastest(result.ops[CreateEntity], n, timeIt([&] {
+        for (size_t i = 0; i < n; ++i)
+            ids.push_back(world.createEntity()); // ids was reserved, so this is just the counter
+    }));
+
+    keepFastest(result.ops[AddComponent], n * types, timeIt([&] {
+        forTypes(types, [&](auto tag) {
+            using C = BenchComponent<decltype(tag)::value>;
+            for (const EntityID e : ids)
+                world.addComponent<C>(e, C{{static_cast<float>(e), 0.0f, 0.0f, 0.0f}});
+        });
+    }));
+
+    if (sampleMemory) {
+        const size_t rssAfter = getMemoryBytes();
+        result.ecsBytesPerEntity = static_cast<double>(world.memoryBytes()) / n;
+        // the allocator may reuse memory freed by an earlier run, so this can read low
+        result.rssBytesPerEntity = rssAfter > rssBefore ? static_cast<double>(rssAfter - rssBefore) / n : 0.0;
+    }
+
+    float sum = 0.0f;
+    keepFastest(result.ops[GetComponentSequential], n * types, timeIt([&] {
+        forTypes(types, [&](auto tag) {
+            using C = BenchComponent<decltype(tag)::value>;
+            for (const EntityID e : ids)
+                sum += world.getComponent<C>(e)->value[0];
+        });
+    }));
+
+    keepFastest(result.ops[GetComponentRandom], n * types, timeIt([&] {
+        forTypes(types, [&](auto tag) {
+            using C = BenchComponent<decltype(tag)::value>;
+            for (const EntityID e : shuffled)
+                sum += world.getComponent<C>(e)->value[0];
+        });
+    }));
+
+    // the pattern the game systems use: query, then look each entity up
+    keepFastest(result.ops[IterateGetEntitiesWith], n * types, timeIt([&] {
+        forTypes(types, [&](auto tag) {
+            using C = BenchComponent<decltype(tag)::value>;
+            for (const EntityID e : world.getEntitiesWith<C>())
+                sum += world.readComponent<C>(e)->value[0];
+        });
+    }));
+    sink = sink + sum;
+
+    keepFastest(result.ops[RemoveComponent], n * types, timeIt([&] {
+        forTypes(types, [&](auto tag) {
+            using C = BenchComponent<decltype(tag)::value>;
+            for (const EntityID e : shuffled)
+                world.removeComponent<C>(e);
+        });
+    }));
+
+    // destroy needs entities that still own their components: refill, untimed
+    forTypes(types, [&](auto tag) {
+        using C = BenchComponent<decltype(tag)::value>;
+        world.reserveComponents<C>(n);
+        for (const EntityID e : ids)
+            world.addComponent<C>(e, C{});
+    });
+    keepFastest(result.ops[DestroyEntity], n, timeIt([&] {
+        for (const EntityID e : shuffled)
+            world.destroyEntity(e);
+    }));
+}
+
+void writeJson(FILE* f, const Options& options, const std::vector<Result>& results) {
+    fprintf(f, "{\n  \"benchmark\": \"ecs_storage\",\n  \"repeat\": %zu,\n  \"seed\": %u,\n  \"results\": [\n",
+            options.repeat, options.seed);
+    for (size_t r = 0; r < results.size(); ++r) {
+        const Result& res = results[r];
+        fprintf(f, "    {\"entities\": %zu, \"component_types\": %zu", res.entities, res.types);
+        if (res.skipped) {
+            fprintf(f, ", \"skipped\": \"exceeds --max-components\"}");
+        } else {
+            fprintf(f, ",\n     \"ops\": {\n");
+            for (int op = 0; op < kOpCount; ++op) {
+                const Measurement& m = res.ops[op];
+                const double ns = m.ops ? m.seconds * 1e9 / m.ops : 0.0;
+                const double perSec = m.seconds > 0.0 ? m.ops / m.seconds : 0.0;
+                fprintf(f, "       \"%s\": {\"count\": %zu, \"ns_per_op\": %.3f, \"ops_per_sec\": %.0f}%s\n",
+                        kOpNames[op], m.ops, ns, perSec, op + 1 < kOpCount ? "," : "");
+            }
+            fprintf(f, "     },\n     \"memory\": {\"ecs_bytes_per_entity\": %.2f, \"rss_bytes_per_entity\": %.2f}}",
+                    res.ecsBytesPerEntity, res.rssBytesPerEntity);
+        }
+        fprintf(f, "%s\n", r + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+bool parseList(const char* text, std::vector<size_t>& out) {
+    out.clear();
+    const char* p = text;
+    while (*p) {
+        char* end = nullptr;
+        const unsigned long long value = strtoull(p, &end, 10);
+        if (end == p || value == 0)
+            return false;
+        out.push_back(static_cast<size_t>(value));
+        p = *end == ',' ? end + 1 : end;
+        if (*end != ',' && *end != '\0')
+            return false;
+    }
+    return !out.empty();
+}
+
+bool parseArgs(const int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--entities") == 0 && hasValue) {
+            if (!parseList(argv[++i], options.entities))
+                return false;
+        } else if (strcmp(argv[i], "--types") == 0 && hasValue) {
+            if (!parseList(argv[++i], options.types))
+                return false;
+            for (const size_t t : options.types) {
+                if (t > kMaxTypes) {
+                    fprintf(stderr, "--types: at most %zu component types\n", kMaxTypes);
+                    return false;
+                }
+            }
+        } else if (strcmp(argv[i], "--repeat") == 0 && hasValue) {
+            options.repeat = std::max<size_t>(1, strtoull(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--max-components") == 0 && hasValue) {
+            options.maxComponents = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            options.seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--out") == 0 && hasValue) {
+            options.out = argv[++i];
+        } else {
+            fprintf(stderr, "unknown or incomplete argument: %s\n", argv[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        fprintf(stderr, "usage: %s [--entities 1000,10000,...] [--types 1,4,16] [--repeat n] "
+                        "[--max-components n] [--seed n] [--out file.json]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<Result> results;
+    std::vector<EntityID> ids, shuffled;
+    for (const size_t n : options.entities) {
+        // a fresh world always hands out ids 1..n
+        shuffled.resize(n);
+        std::iota(shuffled.begin(), shuffled.end(), EntityID{1});
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(options.seed));
+        ids.reserve(n);
+
+        for (const size_t types : options.types) {
+            Result result;
+            result.entities = n;
+            result.types = types;
+            if (n * types > options.maxComponents) {
+                result.skipped = true;
+                results.push_back(result);
+                continue;
+            }
+            fprintf(stderr, "ecs: %zu entities x %zu types\n", n, types);
+            for (size_t r = 0; r < options.repeat; ++r)
+                runOnce(result, shuffled, ids, r == 0);
+            results.push_back(result);
+        }
+    }
+
+    FILE* f = options.out ? fopen(options.out, "w") : stdout;
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", options.out);
+        return 1;
+    }
+    writeJson(f, options, results);
+    if (f != stdout)
+        fclose(f);
+    return 0;
+}
@@ -0,0 +1,30 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_CAMERA_H
+#define DATAORIENTEDDESIGNINGAMEDEV_CAMERA_H
+
+#include <algorithm>
+
+// Viewport into world space: (x, y) is the world position of the screen's top-left
+// corner, w/h the visible size. Render code subtracts x/y to get screen coordinates.
+struct Camera {
+    float x = 0.0f;
+    float y = 0.0f;
+    float w = 0.0f;
+    float h = 0.0f;
+
+    Camera() = default;
+    Camera(const float width, const float height) : w(width), h(height) {}
+
+    void pan(const float dx, const float dy) { x += dx; y += dy; }
+
+    // keep the view inside a worldW x worldH world (centred if the world is smaller)
+    void clampTo(const float worldW, const float worldH) {
+        x = worldW > w ? std::max(0.0f, std::min(x, worldW - w)) : (worldW - w) * 0.5f;
+        y = worldH > h ? std::max(0.0f, std::min(y, worldH - h)) : (worldH - h) * 0.5f;
+    }
+
+    bool sees(const float px, const float py, const float pw, const float ph) const {
+        return px < x + w && px + pw > x && py < y + h && py + ph > y;
+    }
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "ChunkedColumn.h"
+#include <atomic>
+#include <iostream>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace ChunkStorage {
+
+static std::atomic<bool> useHugePages{false};
+
+void setHugePages(const bool enabled) {
+#ifndef __linux__
+    if (enabled)
+        std::cerr << "ChunkStorage: huge pages are only supported on Linux, using the heap" << std::endl;
+#endif
+    useHugePages = enabled;
+}
+
+bool hugePages() {
+    return useHugePages;
+}
+
+#ifdef __linux__
+// anonymous mapping aligned to the chunk size, so the kernel can back it with one huge page
+static void* mapAligned() {
+    const size_t span = kChunkBytes * 2;
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+        return nullptr;
+    const auto base = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = (base + kChunkBytes - 1) & ~(uintptr_t(kChunkBytes) - 1);
+    // trim the slack on both sides
+    if (aligned > base)
+        munmap(raw, aligned - base);
+    if (aligned + kChunkBytes < base + span)
+        munmap(reinterpret_cast<void*>(aligned + kChunkBytes), base + span - aligned - kChunkBytes);
+#ifdef MADV_HUGEPAGE
+    madvise(reinterpret_cast<void*>(aligned), kChunkBytes, MADV_HUGEPAGE);
+#endif
+    return reinterpret_cast<void*>(aligned);
+}
+#endif
+
+void* allocate(bool& mapped) {
+#ifdef __linux__
+    if (useHugePages) {
+        if (void* chunk = mapAligned()) {
+            mapped = true;
+            return chunk;
+        }
+        std::cerr << "ChunkStorage: mmap failed, falling back to the heap" << std::endl;
+        useHugePages = false;
+    }
+#endif
+    mapped = false;
+    return ::operator new(kChunkBytes, std::align_val_t(kAlignment));
+}
+
+void release(void* chunk, const bool mapped) {
+#ifdef __linux__
+    if (mapped) {
+        munmap(chunk, kChunkBytes);
+        return;
+    }
+#endif
+    ::operator delete(chunk, std::align_val_t(kAlignment));
+}
+
+}
@@ -0,0 +1,171 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_CHUNKEDCOLUMN_H
+#define DATAORIENTEDDESIGNINGAMEDEV_CHUNKEDCOLUMN_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Fixed-size storage blocks for ChunkedColumn. A block is one 2 MiB huge page: with huge
+// pages enabled (Linux) it is an anonymous, 2 MiB aligned mapping advised MADV_HUGEPAGE,
+// otherwise a 64-byte aligned heap block.
+namespace ChunkStorage {
+    constexpr size_t kChunkBytes = size_t(2) << 20;
+    constexpr size_t kAlignment = 64;
+
+    void setHugePages(bool enabled); // affects blocks allocated afterwards
+    bool hugePages();
+
+    void* allocate(bool& mapped);
+    void release(void* chunk, bool mapped);
+}
+
+// Array of trivially copyable values in fixed-size chunks. Growth adds a chunk and never
+// moves existing elements, so pointers into a chunk stay valid until the column shrinks
+// below them or is cleared. Element i lives at chunk(i >> kChunkShift)[i & kChunkMask];
+// kernels should walk chunk(k) / chunkLength(k) and stay on contiguous memory.
+// Like Column it can adopt memory it does not own (e.g. a mapped snapshot), used in place;
+// only the partially filled last adopted chunk is copied once the column grows past it.
+template<typename T>
+class ChunkedColumn {
+    static_assert(std::is_trivially_copyable<T>::value, "ChunkedColumn requires trivially copyable elements");
+    static_assert((sizeof(T) & (sizeof(T) - 1)) == 0, "element size must be a power of two");
+
+    static constexpr size_t log2(const size_t v) { return v <= 1 ? 0 : 1 + log2(v >> 1); }
+
+public:
+    static constexpr size_t kChunkSize = ChunkStorage::kChunkBytes / sizeof(T);
+    static constexpr size_t kChunkShift = log2(kChunkSize);
+    static constexpr size_t kChunkMask = kChunkSize - 1;
+
+private:
+    enum class Origin : uint8_t { Heap, Mapped, Borrowed };
+
+    std::vector<T*> chunks;
+    std::vector<Origin> origins;
+    size_t count = 0;
+    size_t borrowedEnd = 0; // elements [0, borrowedEnd) may be written in adopted memory
+    std::shared_ptr<const void> keepAlive; // owner of adopted memory
+
+    void addChunk() {
+        bool mapped = false;
+        chunks.push_back(static_cast<T*>(ChunkStorage::allocate(mapped)));
+        origins.push_back(mapped ? Origin::Mapped : Origin::Heap);
+    }
+
+    // replaces an adopted chunk with an owned copy of its valid part
+    void ownChunk(const size_t k) {
+        bool mapped = false;
+        T* fresh = static_cast<T*>(ChunkStorage::allocate(mapped));
+        const size_t first = k << kChunkShift;
+        if (borrowedEnd > first)
+            std::memcpy(fresh, chunks[k], (borrowedEnd - first) * sizeof(T));
+        chunks[k] = fresh;
+        origins[k] = mapped ? Origin::Mapped : Origin::Heap;
+    }
+
+    // makes index i writable, adding or owning its chunk if needed
+    void ensureWritable(const size_t i) {
+        const size_t k = i >> kChunkShift;
+        while (chunks.size() <= k)
+            addChunk();
+        if (origins[k] == Origin::Borrowed && i >= borrowedEnd)
+            ownChunk(k);
+    }
+
+    void release() {
+        for (size_t k = 0; k < chunks.size(); ++k) {
+            if (origins[k] != Origin::Borrowed)
+                ChunkStorage::release(chunks[k], origins[k] == Origin::Mapped);
+        }
+        chunks.clear();
+        origins.clear();
+        count = borrowedEnd = 0;
+        keepAlive.reset();
+    }
+
+public:
+    ChunkedColumn() = default;
+    ~ChunkedColumn() { release(); }
+
+    ChunkedColumn(const ChunkedColumn&) = delete;
+    ChunkedColumn& operator=(const ChunkedColumn&) = delete;
+
+    ChunkedColumn(ChunkedColumn&& other) noexcept { *this = std::move(other); }
+    ChunkedColumn& operator=(ChunkedColumn&& other) noexcept {
+        if (this == &other) return *this;
+        release();
+        chunks = std::move(other.chunks);
+        origins = std::move(other.origins);
+        count = std::exchange(other.count, 0);
+        borrowedEnd = std::exchange(other.borrowedEnd, 0);
+        keepAlive = std::move(other.keepAlive);
+        other.chunks.clear();
+        other.origins.clear();
+        return *this;
+    }
+
+    // use n contiguous external values in place, split into chunk-sized runs
+    void adopt(T* external, const size_t n, std::shared_ptr<const void> owner) {
+        release();
+        for (size_t first = 0; first < n; first += kChunkSize) {
+            chunks.push_back(external + first);
+            origins.push_back(Origin::Borrowed);
+        }
+        count = borrowedEnd = n;
+        keepAlive = std::move(owner);
+    }
+
+    bool isBorrowed() const { return keepAlive != nullptr; }
+
+    // allocates the chunks for n elements up front; nothing is copied
+    void reserve(const size_t n) {
+        if (n > 0)
+            ensureWritable(n - 1);
+    }
+
+    void push_back(const T& value) {
+        ensureWritable(count);
+        chunks[count >> kChunkShift][count & kChunkMask] = value;
+        ++count;
+    }
+
+    // shrinking keeps the chunks; growing zero-fills chunk by chunk
+    void resize(const size_t n) {
+        while (count < n) {
+            ensureWritable(count);
+            size_t run = std::min(n - count, kChunkSize - (count & kChunkMask));
+            if (origins[count >> kChunkShift] == Origin::Borrowed)
+                run = std::min(run, borrowedEnd - count); // adopted memory ends there
+            std::memset(static_cast<void*>(&(*this)[count]), 0, run * sizeof(T));
+            count += run;
+        }
+        count = n;
+    }
+
+    void pop_back() { --count; }
+
+    void clear() {
+        if (isBorrowed()) release();
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return chunks.size() << kChunkShift; }
+    bool empty() const { return count == 0; }
+
+    T& operator[](const size_t i) { return chunks[i >> kChunkShift][i & kChunkMask]; }
+    const T& operator[](const size_t i) const { return chunks[i >> kChunkShift][i & kChunkMask]; }
+
+    // chunks holding elements, and how many elements chunk k holds
+    size_t chunkCount() const { return (count + kChunkMask) >> kChunkShift; }
+    size_t chunkLength(const size_t k) const { return std::min(kChunkSize, count - (k << kChunkShift)); }
+    T* chunk(const size_t k) { return chunks[k]; }
+    const T* chunk(const size_t k) const { return chunks[k]; }
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_COLUMN_H
+#define DATAORIENTEDDESIGNINGAMEDEV_COLUMN_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Contiguous, 64-byte aligned array of trivially copyable values.
+// Behaves like a minimal std::vector, but can also adopt memory it does not own
+// (e.g. a memory-mapped snapshot). Borrowed memory is used in place until the
+// column has to grow, at which point the data is copied into owned storage.
+template<typename T>
+class Column {
+    static_assert(std::is_trivially_copyable<T>::value, "Column requires trivially copyable elements");
+
+public:
+    static constexpr size_t kAlignment = 64;
+
+private:
+    T* ptr = nullptr;
+    size_t count = 0;
+    size_t cap = 0;
+    bool owned = true;
+    std::shared_ptr<const void> keepAlive; // owner of borrowed memory
+
+    static T* allocate(const size_t n) {
+        if (n == 0) return nullptr;
+        const size_t bytes = (n * sizeof(T) + kAlignment - 1) / kAlignment * kAlignment;
+        return static_cast<T*>(::operator new(bytes, std::align_val_t(kAlignment)));
+    }
+
+    void release() {
+        if (owned && ptr)
+            ::operator delete(ptr, std::align_val_t(kAlignment));
+        ptr = nullptr;
+        count = cap = 0;
+        owned = true;
+        keepAlive.reset();
+    }
+
+    void reallocate(const size_t newCap) {
+        T* fresh = allocate(newCap);
+        if (count > 0)
+            std::memcpy(fresh, ptr, count * sizeof(T));
+        const size_t keep = count;
+        release();
+        ptr = fresh;
+        count = keep;
+        cap = newCap;
+    }
+
+public:
+    Column() = default;
+    ~Column() { release(); }
+
+    Column(const Column& other) { *this = other; }
+    Column& operator=(const Column& other) {
+        if (this == &other) return *this;
+        release();
+        if (other.count > 0) {
+            ptr = allocate(other.count);
+            cap = other.count;
+            count = other.count;
+            std::memcpy(ptr, other.ptr, count * sizeof(T));
+        }
+        return *this;
+    }
+
+    Column(Column&& other) noexcept { *this = std::move(other); }
+    Column& operator=(Column&& other) noexcept {
+        if (this == &other) return *this;
+        release();
+        ptr = std::exchange(other.ptr, nullptr);
+        count = std::exchange(other.count, 0);
+        cap = std::exchange(other.cap, 0);
+        owned = std::exchange(other.owned, true);
+        keepAlive = std::move(other.keepAlive);
+        return *this;
+    }
+
+    // use external memory in place; owner keeps it alive for as long as the column references it
+    void adopt(T* external, const size_t n, std::shared_ptr<const void> owner) {
+        release();
+        ptr = external;
+        count = cap = n;
+        owned = false;
+        keepAlive = std::move(owner);
+    }
+
+    bool isBorrowed() const { return !owned; }
+
+    void reserve(const size_t n) {
+        if (n > cap || (!owned && n > count))
+            reallocate(n);
+    }
+
+    void push_back(const T& value) {
+        if (count == cap || !owned)
+            reallocate(count == 0 ? 16 : count * 2);
+        ptr[count++] = value;
+    }
+
+    void resize(const size_t n) {
+        if (n > cap || (!owned && n > count))
+            reallocate(std::max(n, count * 2));
+        if (n > count)
+            std::memset(static_cast<void*>(ptr + count), 0, (n - count) * sizeof(T));
+        count = n;
+    }
+
+    void pop_back() { --count; }
+
+    void clear() {
+        if (!owned) release();
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+    bool empty() const { return count == 0; }
+
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+    T& operator[](const size_t i) { return ptr[i]; }
+    const T& operator[](const size_t i) const { return ptr[i]; }
+
+    T* begin() { return ptr; }
+    T* end() { return ptr + count; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+};
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_COMMANDBUFFER_H
+#define DATAORIENTEDDESIGNINGAMEDEV_COMMANDBUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include "ECS.h"
+
+// Records structural changes (create/destroy/add/remove) while systems iterate the
+// world, to be applied later at a sync point. One buffer per thread: recording never
+// touches the world except for reserving entity ids, which is atomic.
+class CommandBuffer {
+private:
+    enum class Op : uint8_t { Create, Destroy, Add, Remove };
+
+    // type-erased operations for one component type
+    struct ComponentOps {
+        void (*add)(ECSWorld& world, EntityID entity, const void* payload);
+        void (*remove)(ECSWorld& world, EntityID entity);
+        void (*reserve)(ECSWorld& world, size_t extra);
+        void (*destroy)(void* payload);
+        ComponentTypeID type;
+    };
+
+    template<typename T>
+    static const ComponentOps* opsFor() {
+        static const ComponentOps ops{
+            [](ECSWorld& world, const EntityID entity, const void* payload) {
+                world.addComponent<T>(entity, *static_cast<const T*>(payload));
+            },
+            [](ECSWorld& world, const EntityID entity) { world.removeComponent<T>(entity); },
+            [](ECSWorld& world, const size_t extra) {
+                const auto* pool = world.getComponentArray<T>();
+                world.reserveComponents<T>((pool ? pool->size() : 0) + extra);
+            },
+            [](void* payload) { static_cast<T*>(payload)->~T(); },
+            componentTypeID<T>()
+        };
+        return &ops;
+    }
+
+    struct Command {
+        EntityID entity;
+        Op op;
+        const ComponentOps* ops; // null for Create/Destroy
+        void* payload;           // component copy for Add
+    };
+
+    // payload arena: fixed blocks so recorded components never move
+    static constexpr size_t kBlockSize = 64 * 1024;
+    std::vector<std::unique_ptr<unsigned char[]>> blocks;
+    size_t blockUsed = kBlockSize;
+
+    ECSWorld* world;
+    std::vector<Command> commands;
+
+    // blocks come from new[], so any align up to max_align_t holds for block offsets
+    void* allocate(const size_t size, const size_t align) {
+        size_t offset = (blockUsed + align - 1) / align * align;
+        if (blocks.empty() || offset + size > kBlockSize) {
+            blocks.emplace_back(new unsigned char[std::max(size, kBlockSize)]);
+            offset = 0;
+        }
+        blockUsed = offset + size;
+        return blocks.back().get() + offset;
+    }
+
+    void releasePayloads() {
+        for (const Command& c : commands) {
+            if (c.payload)
+                c.ops->destroy(c.payload);
+        }
+        commands.clear();
+        blocks.resize(std::min<size_t>(blocks.size(), 1)); // keep one block for the next frame
+        blockUsed = 0;
+    }
+
+public:
+    explicit CommandBuffer(ECSWorld& w) : world(&w) {}
+    ~CommandBuffer() { releasePayloads(); }
+
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+    CommandBuffer(CommandBuffer&& other) noexcept : world(other.world) { *this = std::move(other); }
+    // pending commands of the target are dropped first, so their payloads get destroyed
+    CommandBuffer& operator=(CommandBuffer&& other) noexcept {
+        if (this == &other) return *this;
+        releasePayloads();
+        blocks = std::move(other.blocks);
+        blockUsed = std::exchange(other.blockUsed, kBlockSize);
+        world = other.world;
+        commands = std::move(other.commands);
+        other.blocks.clear();
+        other.commands.clear();
+        return *this;
+    }
+
+    // the id is valid immediately, the entity exists once the buffer is applied
+    EntityID create() {
+        const EntityID entity = world->reserveEntities(1);
+        commands.push_back({entity, Op::Create, nullptr, nullptr});
+        return entity;
+    }
+
+    void destroy(const EntityID entity) {
+        commands.push_back({entity, Op::Destroy, nullptr, nullptr});
+    }
+
+    template<typename T>
+    void add(const EntityID entity, const T& component) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned components are not supported");
+        void* payload = new (allocate(sizeof(T), alignof(T))) T(component);
+        commands.push_back({entity, Op::Add, opsFor<T>(), payload});
+    }
+
+    template<typename T>
+    void remove(const EntityID entity) {
+        commands.push_back({entity, Op::Remove, opsFor<T>(), nullptr});
+    }
+
+    size_t size() const { return commands.size(); }
+    bool empty() const { return commands.empty(); }
+
+    // Applies every buffer as one batch, sorted by entity so each entity's changes land
+    // together and pools are appended in id order. Within an entity, commands keep
+    // their buffer order, then record order. The buffers are left empty.
+    static void applyAll(ECSWorld& world, CommandBuffer* buffers, const size_t bufferCount) {
+        struct Ref {
+            EntityID entity;
+            uint32_t buffer;
+            uint32_t index;
+        };
+        std::vector<Ref> refs;
+        size_t total = 0;
+        for (size_t b = 0; b < bufferCount; ++b)
+            total += buffers[b].commands.size();
+        refs.reserve(total);
+
+        // grow each touched pool once up front
+        size_t addsPerType[kMaxComponentTypes] = {};
+        const ComponentOps* opsPerType[kMaxComponentTypes] = {};
+        for (size_t b = 0; b < bufferCount; ++b) {
+            const auto& cmds = buffers[b].commands;
+            for (size_t i = 0; i < cmds.size(); ++i) {
+                refs.push_back({cmds[i].entity, static_cast<uint32_t>(b), static_cast<uint32_t>(i)});
+                if (cmds[i].op == Op::Add) {
+                    addsPerType[cmds[i].ops->type]++;
+                    opsPerType[cmds[i].ops->type] = cmds[i].ops;
+                }
+            }
+        }
+        for (size_t t = 0; t < kMaxComponentTypes; ++t) {
+            if (addsPerType[t] > 0)
+                opsPerType[t]->reserve(world, addsPerType[t]);
+        }
+
+        // refs are already in (buffer, index) order, so a stable sort by entity is enough
+        const auto byEntity = [](const Ref& a, const Ref& b) { return a.entity < b.entity; };
+        if (!std::is_sorted(refs.begin(), refs.end(), byEntity))
+            std::stable_sort(refs.begin(), refs.end(), byEntity);
+
+        for (const Ref& ref : refs) {
+            const Command& c = buffers[ref.buffer].commands[ref.index];
+            switch (c.op) {
+                case Op::Create: break; // id was reserved when recorded
+                case Op::Destroy: world.destroyEntity(c.entity); break;
+                case Op::Add: c.ops->add(world, c.entity, c.payload); break;
+                case Op::Remove: c.ops->remove(world, c.entity); break;
+            }
+        }
+
+        for (size_t b = 0; b < bufferCount; ++b)
+            buffers[b].releasePayloads();
+    }
+
+    void apply() { applyAll(*world, this, 1); }
+};
+
+#endif
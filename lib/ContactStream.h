@@ -0,0 +1,135 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_CONTACTSTREAM_H
+#define DATAORIENTEDDESIGNINGAMEDEV_CONTACTSTREAM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "Column.h"
+
+// One frame of collision contacts in SoA form: pair indices, the contact normal (from the
+// first to the second index) and the penetration depth.
+// Producers write into lanes, one per thread or stage. A lane is preallocated and owned
+// by its writer, so emitting takes no lock and never allocates. A full lane counts the
+// overflow instead, and merge() grows it for the next frame. merge() runs once per frame
+// after the collision stage and concatenates the lanes in lane order. Consumers then walk
+// the merged columns linearly, either all of them or one lane's range.
+class ContactStream {
+public:
+    class alignas(64) Lane { // own cache line, so writers on different threads do not share one
+    private:
+        Column<uint32_t> a, b;
+        Column<float> nx, ny, depth;
+        size_t count = 0;
+        size_t dropped = 0;
+
+        friend class ContactStream;
+
+        void allocate(const size_t capacity) {
+            a.resize(capacity); b.resize(capacity);
+            nx.resize(capacity); ny.resize(capacity); depth.resize(capacity);
+        }
+
+    public:
+        void emit(const uint32_t first, const uint32_t second, const float normalX, const float normalY, const float penetration) {
+            if (count == a.size()) {
+                ++dropped;
+                return;
+            }
+            a[count] = first;
+            b[count] = second;
+            nx[count] = normalX;
+            ny[count] = normalY;
+            depth[count] = penetration;
+            ++count;
+        }
+
+        size_t size() const { return count; }
+        size_t capacity() const { return a.size(); }
+    };
+
+private:
+    std::vector<Lane> lanes;
+    std::vector<size_t> laneStart; // merged offset of each lane, plus the total
+
+    Column<uint32_t> first, second;
+    Column<float> normalX, normalY, penetration;
+    size_t count = 0;
+    size_t dropped = 0;
+
+public:
+    explicit ContactStream(const size_t laneCount = 1, const size_t capacityPerLane = 4096) {
+        setLanes(laneCount, capacityPerLane);
+    }
+
+    // not while a frame is being written
+    void setLanes(const size_t laneCount, const size_t capacityPerLane) {
+        lanes.clear();
+        lanes.resize(std::max<size_t>(1, laneCount));
+        for (Lane& lane : lanes)
+            lane.allocate(capacityPerLane);
+        laneStart.assign(lanes.size() + 1, 0);
+        count = dropped = 0;
+    }
+
+    size_t getLaneCount() const { return lanes.size(); }
+    Lane& lane(const size_t i) { return lanes[i]; }
+
+    // empties every lane and the merged view; call before the collision stage
+    void begin() {
+        for (Lane& lane : lanes)
+            lane.count = lane.dropped = 0;
+        std::fill(laneStart.begin(), laneStart.end(), 0);
+        count = dropped = 0;
+    }
+
+    void merge() {
+        size_t total = 0;
+        for (size_t i = 0; i < lanes.size(); ++i) {
+            laneStart[i] = total;
+            total += lanes[i].count;
+        }
+        laneStart[lanes.size()] = total;
+
+        if (first.size() < total) {
+            first.resize(total); second.resize(total);
+            normalX.resize(total); normalY.resize(total); penetration.resize(total);
+        }
+        dropped = 0;
+        for (size_t i = 0; i < lanes.size(); ++i) {
+            Lane& lane = lanes[i];
+            const size_t at = laneStart[i];
+            const size_t n = lane.count;
+            if (n > 0) {
+                std::memcpy(first.data() + at, lane.a.data(), n * sizeof(uint32_t));
+                std::memcpy(second.data() + at, lane.b.data(), n * sizeof(uint32_t));
+                std::memcpy(normalX.data() + at, lane.nx.data(), n * sizeof(float));
+                std::memcpy(normalY.data() + at, lane.ny.data(), n * sizeof(float));
+                std::memcpy(penetration.data() + at, lane.depth.data(), n * sizeof(float));
+            }
+            // the overflow is lost for this frame; make room for it from the next one on
+            if (lane.dropped > 0) {
+                dropped += lane.dropped;
+                lane.allocate(std::max(lane.capacity() * 2, n + lane.dropped));
+            }
+        }
+        count = total;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t getDropped() const { return dropped; } // contacts that did not fit this frame
+
+    // merged range [laneBegin(i), laneEnd(i)) written by lane i
+    size_t laneBegin(const size_t i) const { return laneStart[i]; }
+    size_t laneEnd(const size_t i) const { return laneStart[i + 1]; }
+
+    const uint32_t* firstIndices() const { return first.data(); }
+    const uint32_t* secondIndices() const { return second.data(); }
+    const float* normalsX() const { return normalX.data(); }
+    const float* normalsY() const { return normalY.data(); }
+    const float* penetrations() const { return penetration.data(); }
+};
+
+#endif
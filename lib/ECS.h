@@ -2,146 +2,478 @@
 #define DATAORIENTEDDESIGNINGAMEDEV_ECS_H
 
 #include <vector>
-#include <unordered_map>
 #include <memory>
-#include <typeindex>
+#include "Column.h"
 #include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 using EntityID = uint32_t;
+using ComponentTypeID = uint32_t;
+using ComponentMask = uint64_t; // one bit per component type an entity has
+
+constexpr size_t kMaxComponentTypes = 64;
+
+// ids index ComponentMask bits and per-type arrays, so the cap holds in every build
+inline ComponentTypeID nextComponentTypeID() {
+    static std::atomic<ComponentTypeID> counter{0};
+    const ComponentTypeID id = counter++;
+    if (id >= kMaxComponentTypes) {
+        std::fprintf(stderr, "ECS: more than %zu component types, ComponentMask has one bit per type\n", kMaxComponentTypes);
+        std::abort();
+    }
+    return id;
+}
+
+// dense per-type id, assigned on first use
+template<typename T>
+ComponentTypeID componentTypeID() {
+    static const ComponentTypeID id = nextComponentTypeID();
+    return id;
+}
+
+inline ComponentTypeID lowestComponentBit(const ComponentMask mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<ComponentTypeID>(index);
+#else
+    return static_cast<ComponentTypeID>(__builtin_ctzll(mask));
+#endif
+}
+
+// query filters for change detection, e.g. getEntitiesWith<Changed<Transform>>(lastSeen)
+// (FilteredType, not Component: a component deriving from the Component base would
+// otherwise look like a filter over itself)
+template<typename T> struct Changed { using FilteredType = T; };
+template<typename T> struct Added { using FilteredType = T; };
+
+template<typename T> struct is_filter : std::false_type {};
+template<typename T> struct is_filter<Changed<T>> : std::true_type {};
+template<typename T> struct is_filter<Added<T>> : std::true_type {};
+
+// non-owning view of a contiguous run of components (C++17 has no std::span)
+template<typename T>
+struct Span {
+    T* ptr = nullptr;
+    size_t count = 0;
+
+    T& operator[](const size_t i) const { return ptr[i]; }
+    size_t size() const { return count; }
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + count; }
+};
+
+// process-wide stamp for structural changes; unique even across pools that get recreated
+inline uint64_t nextStructuralVersion() {
+    static uint64_t counter = 0;
+    return ++counter;
+}
 
+// Optional polymorphic base. Components do not need it: plain structs are detected as
+// trivially copyable and stored in aligned columns that grow and move with memcpy.
 struct Component {
     virtual ~Component() = default;
 };
 
+template<typename T>
+using ComponentStorage = std::conditional_t<std::is_trivially_copyable<T>::value, Column<T>, std::vector<T>>;
+
 class ComponentArray {
 public:
     virtual ~ComponentArray() = default;
     virtual void onEntityDestroyed(EntityID entity) = 0;
+    virtual size_t memoryBytes() const = 0;
 };
 
 template<typename T>
 class ComponentArrayTyped : public ComponentArray {
 private:
-    std::vector<T> components;
-    std::unordered_map<EntityID, size_t> entityToIndex;
-    std::unordered_map<size_t, EntityID> indexToEntity;
+    ComponentStorage<T> components;
+    std::vector<EntityID> indexToEntity; // dense, parallel to components
+    // change ticks, parallel to components; stamped with the world's tick on add / mutable access
+    std::vector<uint32_t> addedTicks;
+    std::vector<uint32_t> changedTicks;
+    const uint32_t* tickSource = nullptr;
+    uint64_t version = nextStructuralVersion(); // changes on every add/remove so systems can cache pool indices
+
+    // entity -> dense index, paged so sparse id ranges cost nothing
+    static constexpr uint32_t kPageBits = 12;
+    static constexpr uint32_t kPageSize = 1u << kPageBits;
+    static constexpr uint32_t kAbsent = UINT32_MAX;
+    std::vector<std::unique_ptr<uint32_t[]>> entityToIndex;
+
+    uint32_t lookup(const EntityID entity) const {
+        const size_t page = entity >> kPageBits;
+        if (page >= entityToIndex.size() || !entityToIndex[page])
+            return kAbsent;
+        return entityToIndex[page][entity & (kPageSize - 1)];
+    }
+
+    uint32_t& slot(const EntityID entity) {
+        const size_t page = entity >> kPageBits;
+        if (page >= entityToIndex.size())
+            entityToIndex.resize(page + 1);
+        if (!entityToIndex[page]) {
+            entityToIndex[page].reset(new uint32_t[kPageSize]);
+            std::fill(entityToIndex[page].get(), entityToIndex[page].get() + kPageSize, kAbsent);
+        }
+        return entityToIndex[page][entity & (kPageSize - 1)];
+    }
+
+    uint32_t now() const { return tickSource ? *tickSource : 0; }
 
 public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    void setTickSource(const uint32_t* tick) { tickSource = tick; }
+
     void addComponent(const EntityID entity, const T& component) {
-        const size_t index = components.size();
+        uint32_t& index = slot(entity);
+        if (index != kAbsent) {
+            components[index] = component; // already present: overwrite
+            changedTicks[index] = now();
+            return;
+        }
+        index = static_cast<uint32_t>(components.size());
         components.push_back(component);
-        entityToIndex[entity] = index;
-        indexToEntity[index] = entity;
+        indexToEntity.push_back(entity);
+        addedTicks.push_back(now());
+        changedTicks.push_back(now());
+        version = nextStructuralVersion();
+    }
+
+    // appends count copies of prototype for the new entities [first, first + count)
+    Span<T> appendComponents(const EntityID first, const size_t count, const T& prototype) {
+        const size_t base = components.size();
+        components.resize(base + count);
+        std::fill(components.begin() + base, components.begin() + base + count, prototype);
+        indexToEntity.resize(base + count);
+        addedTicks.resize(base + count, now());
+        changedTicks.resize(base + count, now());
+        for (size_t i = 0; i < count; ++i) {
+            const EntityID entity = first + static_cast<EntityID>(i);
+            slot(entity) = static_cast<uint32_t>(base + i);
+            indexToEntity[base + i] = entity;
+        }
+        version = nextStructuralVersion();
+        return {components.data() + base, count};
     }
 
     void removeComponent(const EntityID entity) {
-        if (entityToIndex.find(entity) == entityToIndex.end())
+        const uint32_t removeIndex = lookup(entity);
+        if (removeIndex == kAbsent)
             return;
 
-        size_t removeIndex = entityToIndex[entity];
-        size_t lastIndex = components.size() - 1;
+        const size_t lastIndex = components.size() - 1;
 
         if (removeIndex != lastIndex) {
             components[removeIndex] = components[lastIndex];
+            addedTicks[removeIndex] = addedTicks[lastIndex];
+            changedTicks[removeIndex] = changedTicks[lastIndex];
             const EntityID lastEntity = indexToEntity[lastIndex];
-            entityToIndex[lastEntity] = removeIndex;
+            slot(lastEntity) = removeIndex;
             indexToEntity[removeIndex] = lastEntity;
         }
 
         components.pop_back();
-        entityToIndex.erase(entity);
-        indexToEntity.erase(lastIndex);
+        indexToEntity.pop_back();
+        addedTicks.pop_back();
+        changedTicks.pop_back();
+        slot(entity) = kAbsent;
+        version = nextStructuralVersion();
     }
 
+    // mutable access counts as a change
     T* getComponent(const EntityID entity) {
-        if (entityToIndex.find(entity) == entityToIndex.end())
+        const uint32_t index = lookup(entity);
+        if (index == kAbsent)
             return nullptr;
-        return &components[entityToIndex[entity]];
+        changedTicks[index] = now();
+        return &components[index];
+    }
+
+    const T* readComponent(const EntityID entity) const {
+        const uint32_t index = lookup(entity);
+        return index == kAbsent ? nullptr : &components[index];
+    }
+
+    // dense access by pool index (0..size-1); the mutable overload marks the whole pool changed
+    size_t size() const { return components.size(); }
+    T* data() {
+        std::fill(changedTicks.begin(), changedTicks.end(), now());
+        return components.data();
+    }
+    const T* data() const { return components.data(); }
+
+    // for systems that know exactly what they write: no marking, call markChanged per element
+    T* dataUntracked() { return components.data(); }
+    void markChanged(const size_t index) { changedTicks[index] = now(); }
+
+    bool changedSince(const size_t index, const uint32_t tick) const { return changedTicks[index] > tick; }
+    bool addedSince(const size_t index, const uint32_t tick) const { return addedTicks[index] > tick; }
+    const EntityID* entities() const { return indexToEntity.data(); }
+    const T* getComponentAt(const size_t index) const { return &components[index]; }
+    EntityID getEntityAt(const size_t index) const { return indexToEntity[index]; }
+    uint64_t getVersion() const { return version; }
+
+    size_t indexOf(const EntityID entity) const {
+        const uint32_t index = lookup(entity);
+        return index == kAbsent ? npos : index;
+    }
+
+    void reserve(const size_t count) {
+        components.reserve(count);
+        indexToEntity.reserve(count);
+        addedTicks.reserve(count);
+        changedTicks.reserve(count);
     }
 
     std::vector<EntityID> getEntities() const {
-        std::vector<EntityID> entities;
-        for (const auto& [entity, _] : entityToIndex)
-            entities.push_back(entity);
-        return entities;
+        return indexToEntity;
+    }
+
+    std::vector<EntityID> getEntitiesChangedSince(const uint32_t tick) const {
+        std::vector<EntityID> result;
+        for (size_t i = 0; i < changedTicks.size(); ++i) {
+            if (changedTicks[i] > tick)
+                result.push_back(indexToEntity[i]);
+        }
+        return result;
+    }
+
+    std::vector<EntityID> getEntitiesAddedSince(const uint32_t tick) const {
+        std::vector<EntityID> result;
+        for (size_t i = 0; i < addedTicks.size(); ++i) {
+            if (addedTicks[i] > tick)
+                result.push_back(indexToEntity[i]);
+        }
+        return result;
+    }
+
+    // Takes over n trivially copyable components in place (e.g. from a mapped snapshot);
+    // owner keeps the memory alive. Only valid on an empty pool.
+    void adoptComponents(T* external, const EntityID* owners, const size_t n, std::shared_ptr<const void> owner) {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable pools can adopt memory");
+        assert(components.size() == 0);
+        components.adopt(external, n, std::move(owner));
+        indexToEntity.assign(owners, owners + n);
+        addedTicks.assign(n, now());
+        changedTicks.assign(n, now());
+        for (size_t i = 0; i < n; ++i)
+            slot(owners[i]) = static_cast<uint32_t>(i);
+        version = nextStructuralVersion();
     }
 
     void onEntityDestroyed(const EntityID entity) override {
         removeComponent(entity);
     }
+
+    // bytes reserved by this pool: components, parallel arrays and sparse pages
+    size_t memoryBytes() const override {
+        size_t pages = 0;
+        for (const auto& page : entityToIndex)
+            pages += page ? kPageSize * sizeof(uint32_t) : 0;
+        return components.capacity() * sizeof(T) + indexToEntity.capacity() * sizeof(EntityID) +
+               (addedTicks.capacity() + changedTicks.capacity()) * sizeof(uint32_t) +
+               entityToIndex.capacity() * sizeof(entityToIndex[0]) + pages;
+    }
 };
 
 class ECSWorld {
 private:
-    EntityID nextEntityID = 1;
-    std::unordered_map<std::type_index, std::shared_ptr<ComponentArray>> componentArrays;
-    std::unordered_map<EntityID, std::vector<std::type_index>> entityComponents;
+    std::atomic<EntityID> nextEntityID{1}; // atomic so command buffers on other threads can reserve ids
+    std::vector<std::unique_ptr<ComponentArray>> componentArrays; // indexed by ComponentTypeID
+    std::vector<ComponentMask> entityMasks; // indexed by EntityID
+    uint32_t changeTick = 1; // stamped into components on add / mutable access
+
+    template<typename T>
+    ComponentArrayTyped<T>* getOrCreateArray() {
+        const ComponentTypeID id = componentTypeID<T>();
+        if (id >= componentArrays.size())
+            componentArrays.resize(id + 1);
+        if (!componentArrays[id]) {
+            auto array = std::make_unique<ComponentArrayTyped<T>>();
+            array->setTickSource(&changeTick);
+            componentArrays[id] = std::move(array);
+        }
+        return static_cast<ComponentArrayTyped<T>*>(componentArrays[id].get());
+    }
+
+    ComponentMask& maskOf(const EntityID entity) {
+        if (entity >= entityMasks.size())
+            entityMasks.resize(std::max<size_t>(entity + 1, entityMasks.size() * 2), 0);
+        return entityMasks[entity];
+    }
+
+    template<typename T>
+    static ComponentMask bitOf() { return ComponentMask{1} << componentTypeID<T>(); }
 
 public:
     EntityID createEntity() {
         return nextEntityID++;
     }
 
+    // reserves count consecutive ids without touching any pool; returns the first
+    EntityID reserveEntities(const size_t count) {
+        return nextEntityID.fetch_add(static_cast<EntityID>(count));
+    }
+
+    // Change detection: a system remembers the value returned by markSeen() and later asks
+    // for Changed<T>/Added<T> since then. Every write after markSeen() carries a newer tick.
+    uint32_t getTick() const { return changeTick; }
+    uint32_t markSeen() { return changeTick++; }
+
+    EntityID getNextEntityID() const { return nextEntityID.load(); }
+    void setNextEntityID(const EntityID id) { nextEntityID = id; }
+
+    // drops every entity and component pool
+    void clear() {
+        componentArrays.clear();
+        entityMasks.clear();
+        nextEntityID = 1;
+    }
+
+    // bytes reserved by every pool plus the entity masks; borrowed (mapped) columns count too
+    size_t memoryBytes() const {
+        size_t total = entityMasks.capacity() * sizeof(ComponentMask);
+        for (const auto& array : componentArrays) {
+            if (array)
+                total += array->memoryBytes();
+        }
+        return total;
+    }
+
     void destroyEntity(const EntityID entity) {
-        if (entityComponents.find(entity) == entityComponents.end())
+        if (entity >= entityMasks.size() || entityMasks[entity] == 0)
             return;
 
-        for (const auto& typeIdx : entityComponents[entity]) {
-            componentArrays[typeIdx]->onEntityDestroyed(entity);
+        ComponentMask mask = entityMasks[entity];
+        while (mask) {
+            componentArrays[lowestComponentBit(mask)]->onEntityDestroyed(entity);
+            mask &= mask - 1;
         }
-        entityComponents.erase(entity);
+        entityMasks[entity] = 0;
     }
 
-    template<typename T>
-    void addComponent(EntityID entity, const T& component) {
-        const std::type_index typeIdx(typeid(T));
+    // creates count entities that all start with copies of the given components;
+    // every pool grows once. Returns the first id of the contiguous range.
+    template<typename... Ts>
+    EntityID createEntities(const size_t count, const Ts&... prototypes) {
+        return createEntitiesWith<Ts...>(count, [](EntityID, Span<Ts>...) {}, prototypes...);
+    }
 
-        if (componentArrays.find(typeIdx) == componentArrays.end()) {
-            componentArrays[typeIdx] = std::make_shared<ComponentArrayTyped<T>>();
-        }
+    // like createEntities, then hands the freshly appended pool ranges to
+    // init(firstID, Span<Ts>...) so callers can fill them in one pass
+    template<typename... Ts, typename Init>
+    EntityID createEntitiesWith(const size_t count, Init&& init, const Ts&... prototypes) {
+        const EntityID first = reserveEntities(count);
+        if (count == 0)
+            return first;
+        maskOf(first + static_cast<EntityID>(count - 1));
+        const ComponentMask mask = (bitOf<Ts>() | ... | ComponentMask{0});
+        std::fill(entityMasks.begin() + first, entityMasks.begin() + first + count, mask);
+        init(first, getOrCreateArray<Ts>()->appendComponents(first, count, prototypes)...);
+        return first;
+    }
 
-        auto* array = static_cast<ComponentArrayTyped<T>*>(componentArrays[typeIdx].get());
-        array->addComponent(entity, component);
+    template<typename... Ts, typename Init>
+    EntityID createEntitiesWith(const size_t count, Init&& init) {
+        return createEntitiesWith<Ts...>(count, std::forward<Init>(init), Ts{}...);
+    }
 
-        entityComponents[entity].push_back(typeIdx);
+    template<typename T>
+    void addComponent(EntityID entity, const T& component) {
+        getOrCreateArray<T>()->addComponent(entity, component);
+        maskOf(entity) |= bitOf<T>();
     }
 
     template<typename T>
     void removeComponent(EntityID entity) {
-        const std::type_index typeIdx(typeid(T));
-
-        if (componentArrays.find(typeIdx) == componentArrays.end())
+        if (!hasComponent<T>(entity))
             return;
+        getComponentArray<T>()->removeComponent(entity);
+        entityMasks[entity] &= ~bitOf<T>();
+    }
 
-        auto* array = static_cast<ComponentArrayTyped<T>*>(componentArrays[typeIdx].get());
-        array->removeComponent(entity);
-
-        auto& components = entityComponents[entity];
-        components.erase(std::remove(components.begin(), components.end(), typeIdx), components.end());
+    template<typename T>
+    bool hasComponent(const EntityID entity) const {
+        return entity < entityMasks.size() && (entityMasks[entity] & bitOf<T>()) != 0;
     }
 
+    // mutable access marks the component changed; use readComponent to only look
     template<typename T>
     T* getComponent(EntityID entity) {
-        const std::type_index typeIdx(typeid(T));
+        if (!hasComponent<T>(entity))
+            return nullptr;
+        return getComponentArray<T>()->getComponent(entity);
+    }
 
-        if (componentArrays.find(typeIdx) == componentArrays.end())
+    template<typename T>
+    const T* readComponent(EntityID entity) const {
+        if (!hasComponent<T>(entity))
             return nullptr;
+        return getComponentArray<T>()->readComponent(entity);
+    }
 
-        auto* array = static_cast<ComponentArrayTyped<T>*>(componentArrays[typeIdx].get());
-        return array->getComponent(entity);
+    template<typename T>
+    ComponentArrayTyped<T>* getComponentArray() {
+        const ComponentTypeID id = componentTypeID<T>();
+        if (id >= componentArrays.size())
+            return nullptr;
+        return static_cast<ComponentArrayTyped<T>*>(componentArrays[id].get());
     }
 
     template<typename T>
-    std::vector<EntityID> getEntitiesWith() {
-        const std::type_index typeIdx(typeid(T));
+    const ComponentArrayTyped<T>* getComponentArray() const {
+        const ComponentTypeID id = componentTypeID<T>();
+        if (id >= componentArrays.size())
+            return nullptr;
+        return static_cast<const ComponentArrayTyped<T>*>(componentArrays[id].get());
+    }
 
-        if (componentArrays.find(typeIdx) == componentArrays.end())
-            return {};
+    // zero-copy import of a whole pool; the entities must not have T yet
+    template<typename T>
+    void adoptComponents(T* external, const EntityID* owners, const size_t n, std::shared_ptr<const void> owner) {
+        getOrCreateArray<T>()->adoptComponents(external, owners, n, std::move(owner));
+        for (size_t i = 0; i < n; ++i)
+            maskOf(owners[i]) |= bitOf<T>();
+    }
 
-        auto* array = static_cast<ComponentArrayTyped<T>*>(componentArrays[typeIdx].get());
+    template<typename T>
+    void reserveComponents(const size_t count) {
+        getOrCreateArray<T>()->reserve(count);
+    }
+
+    template<typename T>
+    std::vector<EntityID> getEntitiesWith() {
+        const auto* array = getComponentArray<T>();
+        if (!array)
+            return {};
         return array->getEntities();
     }
+
+    // filtered queries: getEntitiesWith<Changed<T>>(since) / getEntitiesWith<Added<T>>(since)
+    template<typename Filter>
+    std::vector<EntityID> getEntitiesWith(const uint32_t since) const {
+        static_assert(is_filter<Filter>::value, "use Changed<T> or Added<T> with a tick");
+        const auto* array = getComponentArray<typename Filter::FilteredType>();
+        if (!array)
+            return {};
+        if constexpr (std::is_same<Filter, Changed<typename Filter::FilteredType>>::value)
+            return array->getEntitiesChangedSince(since);
+        else
+            return array->getEntitiesAddedSince(since);
+    }
 };
 
 #endif
\ No newline at end of file
@@ -1,6 +1,12 @@
 #include "Engine.h"
+#include "Utils.h"
 #include <SDL3_image/SDL_image.h>
+#include <algorithm>
 #include <iostream>
+#include <random>
+
+// how much of a frame wait is spun instead of slept, to cover OS sleep granularity
+static constexpr double kSpinMarginMs = 2.0;
 
 GameEngine::GameEngine(const int width, const int height, const char* title)
     : window(nullptr), renderer(nullptr), font(nullptr),
@@ -73,7 +79,90 @@ int GameEngine::loadTexture(const char* path) {
     return static_cast<int>(textures.size()) - 1; // return texture ID
 }
 
+bool GameEngine::startRecording(const char* path) {
+    const uint32_t seed = std::random_device{}();
+    if (!recorder.open(path, seed))
+        return false;
+    seedRandom(seed);
+    return true;
+}
+
+bool GameEngine::startReplay(const char* path, const float fixedStepSeconds) {
+    if (!replay.open(path))
+        return false;
+    seedRandom(replay.getSeed());
+    fixedStep = fixedStepSeconds;
+    input.keys.clear();
+    PerformanceMonitor_RecordHistory(&perf, true);
+    return true;
+}
+
+bool GameEngine::startBenchmark(const size_t frames, const float fixedStepSeconds) {
+    if (frames == 0)
+        return false;
+    constexpr uint32_t kBenchmarkSeed = 12345; // every run sees the same spawn pattern
+    seedRandom(kBenchmarkSeed);
+    fixedStep = fixedStepSeconds;
+    benchmarkFramesLeft = frames;
+    benchmarking = true;
+    PerformanceMonitor_RecordHistory(&perf, true);
+    return true;
+}
+
+bool GameEngine::setVSync(const bool enabled) {
+    if (!SDL_SetRenderVSync(renderer, enabled ? 1 : 0)) {
+        std::cerr << "VSync change failed: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    vsync = enabled;
+    return true;
+}
+
+void GameEngine::waitForNextFrame() {
+    // replays run flat out unless a cap was asked for explicitly
+    const bool throttle = idle && !replay.isOpen();
+    const float fps = throttle ? (targetFps > 0.0f ? std::min(targetFps, idleFps) : idleFps) : targetFps;
+    if (fps <= 0.0f) {
+        nextFrameDeadline = 0;
+        return;
+    }
+
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    const auto period = static_cast<Uint64>(static_cast<double>(freq) / fps);
+    const Uint64 now = SDL_GetPerformanceCounter();
+    // deadlines advance by whole periods so the rate does not drift
+    if (nextFrameDeadline == 0)
+        nextFrameDeadline = lastFrameCounter;
+    nextFrameDeadline += period;
+    if (now >= nextFrameDeadline) {
+        nextFrameDeadline = now; // over budget: start the next frame now, don't try to catch up
+        return;
+    }
+
+    const Uint64 remaining = nextFrameDeadline - now;
+    if (throttle) {
+        // block in the event queue so input still wakes the loop immediately
+        const auto ms = static_cast<Sint32>(static_cast<double>(remaining) * 1000.0 / static_cast<double>(freq));
+        if (ms > 0 && SDL_WaitEventTimeout(nullptr, ms))
+            nextFrameDeadline = SDL_GetPerformanceCounter();
+        return;
+    }
+
+    const auto margin = static_cast<Uint64>(static_cast<double>(freq) * kSpinMarginMs / 1000.0);
+    if (remaining > margin)
+        SDL_DelayNS(static_cast<Uint64>(static_cast<double>(remaining - margin) * 1e9 / static_cast<double>(freq)));
+    while (SDL_GetPerformanceCounter() < nextFrameDeadline) {
+        // spin for the last stretch
+    }
+}
+
+void GameEngine::stampInput(const Uint64 timestampNs) {
+    if (inputStampNs == 0 || timestampNs < inputStampNs)
+        inputStampNs = timestampNs;
+}
+
 void GameEngine::processInput() {
+    pollStampNs = SDL_GetTicksNS();
     SDL_Event e;
     while (SDL_PollEvent(&e)) {
         // ESC key / window close / OS decides to close it etc.
@@ -81,15 +170,50 @@ void GameEngine::processInput() {
             input.quit = true;
             running = false;
         }
+        // live keys are ignored during replay, except ESC to abort it
+        if (replay.isOpen()) {
+            if (e.type == SDL_EVENT_KEY_DOWN && e.key.key == SDLK_ESCAPE) {
+                input.quit = true;
+                running = false;
+            }
+            continue;
+        }
         // Key down/up events
         if (e.type == SDL_EVENT_KEY_DOWN) {
+            if (!(input.keys.count(e.key.key) && input.keys.at(e.key.key))) {
+                if (recorder.isOpen())
+                    recorder.recordKey(e.key.key, true);
+                stampInput(e.key.timestamp); // auto-repeat doesn't count as new input
+            }
             input.keys[e.key.key] = true;
         }
 
         if (e.type == SDL_EVENT_KEY_UP) {
+            if (recorder.isOpen())
+                recorder.recordKey(e.key.key, false);
+            stampInput(e.key.timestamp);
             input.keys[e.key.key] = false;
         }
     }
+
+    if (recorder.isOpen())
+        recorder.endFrame(deltaTime);
+
+    if (replay.isOpen()) {
+        float recordedDt = 0.0f;
+        if (!replay.nextFrame(recordedDt, replayEvents)) {
+            running = false; // end of recording
+            return;
+        }
+        deltaTime = fixedStep > 0.0f ? fixedStep : recordedDt;
+        // replayed input has no OS timestamp; it is measured from the moment it is injected
+        if (!replayEvents.empty())
+            stampInput(pollStampNs);
+        for (const InputEvent& ev : replayEvents)
+            input.keys[ev.key] = ev.down != 0;
+    }
+    if (benchmarking && fixedStep > 0.0f)
+        deltaTime = fixedStep;
     // Check for ESC key
     if (input.keys.count(SDLK_ESCAPE) && input.keys.at(SDLK_ESCAPE)) {
         input.quit = true;
@@ -99,6 +223,15 @@ void GameEngine::processInput() {
 
 void GameEngine::update(const float dt) {
     onUpdate(dt);
+    updateDoneNs = SDL_GetTicksNS();
+}
+
+void GameEngine::recordBusyTime() {
+    if (frameStartCounter == 0)
+        return;
+    const Uint64 now = SDL_GetPerformanceCounter();
+    PerformanceMonitor_RecordBusy(&perf, static_cast<float>(static_cast<double>(now - frameStartCounter) * 1000.0 /
+                                                            static_cast<double>(SDL_GetPerformanceFrequency())));
 }
 
 void GameEngine::render() {
@@ -110,7 +243,23 @@ void GameEngine::render() {
     PerformanceMonitor_Update(&perf, renderer, font, 0);
     PerformanceMonitor_Draw(&perf, renderer);
 
+    // present is work, unless vsync makes it block until the display refreshes
+    if (vsync)
+        recordBusyTime();
     SDL_RenderPresent(renderer);
+    if (!vsync)
+        recordBusyTime();
+
+    if (inputStampNs != 0) {
+        // the frame that reacted to the input is now handed to the display
+        const Uint64 presentedNs = SDL_GetTicksNS();
+        const auto ms = [](const Uint64 from, const Uint64 to) {
+            return to > from ? static_cast<float>(static_cast<double>(to - from) / 1e6) : 0.0f;
+        };
+        PerformanceMonitor_RecordLatency(&perf, ms(inputStampNs, pollStampNs), ms(pollStampNs, updateDoneNs),
+                                         ms(updateDoneNs, presentedNs));
+        inputStampNs = 0;
+    }
 }
 
 void GameEngine::loop() {
@@ -118,11 +267,22 @@ void GameEngine::loop() {
         const Uint64 now = SDL_GetPerformanceCounter();
         deltaTime = static_cast<float>(now - lastFrameCounter) / static_cast<float>(SDL_GetPerformanceFrequency());
         lastFrameCounter = now;
+        frameStartCounter = now;
 
         processInput();
+        if (!isRunning()) break;
         update(deltaTime);
         render();
+        waitForNextFrame();
+        if (benchmarking && --benchmarkFramesLeft == 0)
+            running = false;
+    }
+
+    if (replay.isOpen() || benchmarking) {
+        PerformanceMonitor_PrintSummary(&perf, benchmarking ? "Benchmark summary" : "Replay summary");
+        onSummary();
     }
+    recorder.close();
 }
 
 void GameEngine::shutdown() {
@@ -4,6 +4,7 @@
 #include <SDL3/SDL.h>
 #include <SDL3_ttf/SDL_ttf.h>
 #include "PerformanceMonitor.h"
+#include "InputRecorder.h"
 #include <vector>
 #include <unordered_map>
 
@@ -27,6 +28,34 @@ protected:
     Uint64 lastFrameCounter;
     bool running;
 
+    // deterministic input record/replay
+    InputRecorder recorder;
+    InputReplay replay;
+    std::vector<InputEvent> replayEvents;
+    float fixedStep = 0.0f; // replay/benchmark timestep in seconds, 0 = recorded dt
+
+    // scripted benchmark: a fixed number of frames with a fixed seed and timestep
+    size_t benchmarkFramesLeft = 0;
+    bool benchmarking = false;
+
+    // frame pacing: sleep most of the wait, spin the last stretch on the performance counter
+    float targetFps = 0.0f;   // 0 = uncapped
+    float idleFps = 20.0f;    // cap while the game reports nothing is animating
+    bool idle = false;
+    bool vsync = false;
+    Uint64 nextFrameDeadline = 0;
+    Uint64 frameStartCounter = 0; // start of the current frame, for the busy time
+
+    void recordBusyTime();
+
+    void waitForNextFrame();
+
+    // input-to-photon latency of the oldest input consumed this frame (SDL_GetTicksNS time base)
+    Uint64 inputStampNs = 0; // 0 = no input this frame
+    Uint64 pollStampNs = 0;
+    Uint64 updateDoneNs = 0;
+
+    void stampInput(Uint64 timestampNs);
 
 public:
     GameEngine(int width, int height, const char* title);
@@ -41,6 +70,17 @@ public:
     void loop();
     void shutdown();
 
+    bool startRecording(const char* path);
+    bool startReplay(const char* path, float fixedStepSeconds);
+    bool isReplaying() const { return replay.isOpen(); }
+    bool startBenchmark(size_t frames, float fixedStepSeconds);
+    bool isBenchmarking() const { return benchmarking; }
+
+    void setTargetFps(const float fps) { targetFps = fps > 0.0f ? fps : 0.0f; nextFrameDeadline = 0; }
+    void setIdleFps(const float fps) { idleFps = fps; }
+    void setIdle(const bool enabled) { idle = enabled; } // e.g. a static menu
+    bool setVSync(bool enabled);
+
     SDL_Renderer* getRenderer() const { return renderer; }
     TTF_Font* getFont() const { return font; }
     SDL_Texture* getTexture(const int id) const {
@@ -53,10 +93,13 @@ public:
 
     int loadTexture(const char* path);
     void setMonitoredParticleCount(const size_t count) { perf.monitored_count = count; }
+    void setOverlayStatus(const char* status) { PerformanceMonitor_SetStatus(&perf, status); }
+    const PerformanceMonitor& getPerformance() const { return perf; }
 
 protected:
     virtual void onUpdate(float dt) {}
     virtual void onRender() {}
+    virtual void onSummary() {} // after the replay/benchmark summary is printed
 };
 
 #endif
\ No newline at end of file
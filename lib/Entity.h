@@ -3,7 +3,8 @@
 
 #include "ECS.h"
 
-struct Transform : Component {
+// Plain structs: no Component base, so pools use the trivially copyable fast path.
+struct Transform {
     float x, y; // position
     float vx, vy; // velocity
     float w, h; // width and height
@@ -12,15 +13,15 @@ struct Transform : Component {
         : x(x), y(y), vx(vx), vy(vy), w(w), h(h) {}
 };
 
-struct Renderable : Component {
+struct Renderable {
     int textureID;
 
     explicit Renderable(const int texID = 0)
         : textureID(texID) {}
 };
 
-struct Paddle : Component { float speed = 500.0f; };
-struct Ball : Component { float speed = 500.0f; };
+struct Paddle { float speed = 500.0f; };
+struct Ball { float speed = 500.0f; };
 
 inline EntityID createPaddle(ECSWorld& world, const float x, const float y, const float w, const float h) {
     const EntityID e = world.createEntity();
@@ -38,4 +39,6 @@ inline EntityID createBall(ECSWorld& world, const float x, const float y, const
     return e;
 }
 
+static_assert(std::is_trivially_copyable<Transform>::value && sizeof(Transform) == 24, "Transform should stay a 24-byte POD");
+
 #endif
\ No newline at end of file
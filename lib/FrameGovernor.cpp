@@ -0,0 +1,81 @@
+#include "FrameGovernor.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+// cheapest last; level 1 matches the fixed settings used before the governor
+static const FrameGovernor::Lod kLadder[] = {
+    // cap, collide every, substeps, visible, stride
+    {32, 1, 2, 1.00f, 1},
+    {32, 1, 1, 1.00f, 1},
+    {16, 1, 1, 1.00f, 1},
+    {16, 2, 1, 1.00f, 1},
+    { 8, 2, 1, 1.00f, 2},
+    { 8, 3, 1, 0.50f, 2},
+    { 4, 4, 1, 0.25f, 4},
+};
+static constexpr int kLevels = static_cast<int>(sizeof(kLadder) / sizeof(kLadder[0]));
+static_assert(kLevels <= 16, "retryAt/backoff hold 16 levels");
+
+FrameGovernor::FrameGovernor() { reset(); }
+
+FrameGovernor::FrameGovernor(const Config& cfg) : config(cfg) { reset(); }
+
+int FrameGovernor::getLevelCount() { return kLevels; }
+
+const FrameGovernor::Lod& FrameGovernor::getLod() const { return kLadder[level]; }
+
+void FrameGovernor::reset() {
+    level = kDefaultLevel;
+    cooldown = config.settleFrames;
+    frame = 0;
+    calmFrames = 0;
+    std::fill(std::begin(retryAt), std::end(retryAt), 0);
+    std::fill(std::begin(backoff), std::end(backoff), 1);
+    strcpy(lastDecision, "hold");
+}
+
+bool FrameGovernor::update(const PerformanceMonitor& pm) {
+    frame++;
+    const float ms = pm.smoothed_busy_ms;
+    if (ms <= 0.0f)
+        return false;
+
+    calmFrames = ms <= config.targetMs ? calmFrames + 1 : 0;
+    if (calmFrames >= config.recoverFrames) {
+        for (int& b : backoff)
+            b = std::max(b / 2, 1);
+        calmFrames = 0;
+    }
+
+    if (cooldown > 0) {
+        cooldown--;
+        return false;
+    }
+
+    if (ms > config.targetMs * (1.0f + config.hysteresis) && level + 1 < kLevels) {
+        // the level we leave is retried later, twice as late each time it fails
+        retryAt[level] = frame + static_cast<uint64_t>(config.settleFrames) * 4 * backoff[level];
+        backoff[level] = std::min(backoff[level] * 2, 64);
+        level++;
+        cooldown = config.settleFrames;
+        snprintf(lastDecision, sizeof(lastDecision), "down (%.1f ms)", ms);
+        return true;
+    }
+    if (ms < config.targetMs * (1.0f - config.hysteresis) && level > 0 && frame >= retryAt[level - 1]) {
+        level--;
+        cooldown = config.settleFrames;
+        snprintf(lastDecision, sizeof(lastDecision), "up (%.1f ms)", ms);
+        return true;
+    }
+    return false;
+}
+
+void FrameGovernor::describe(const PerformanceMonitor& pm, char* out, const size_t size) const {
+    const Lod& lod = getLod();
+    snprintf(out, size, "LOD %d/%d: cap %zu, collide 1/%d, substeps %d, visible %d%%, stride %d | %.1f/%.1f ms %s",
+             level, kLevels - 1, lod.collisionCap, lod.collisionInterval, lod.substeps,
+             static_cast<int>(lod.visibleFraction * 100.0f), lod.renderStride,
+             pm.smoothed_busy_ms, config.targetMs, lastDecision);
+}
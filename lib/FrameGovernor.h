@@ -0,0 +1,62 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_FRAMEGOVERNOR_H
+#define DATAORIENTEDDESIGNINGAMEDEV_FRAMEGOVERNOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include "PerformanceMonitor.h"
+
+// Holds a target frame time by walking a ladder of simulation/render LOD levels.
+// Reads the smoothed busy time (the frame's work, without frame-limiter or vsync waits)
+// from PerformanceMonitor once per frame, steps one
+// level at a time and waits for the stats to settle after each step. A level that
+// had to be left for being over budget is retried with exponential backoff, so the
+// governor does not oscillate between two neighbouring levels. The backoff halves after
+// every long enough run within budget, so transient spikes are forgotten.
+class FrameGovernor {
+public:
+    struct Config {
+        float targetMs = 1000.0f / 60.0f;
+        float hysteresis = 0.15f; // degrade above target * (1 + h), upgrade below target * (1 - h)
+        int settleFrames = 30;    // frames to wait after a change before judging it
+        int recoverFrames = 600;  // frames within budget in a row that halve every backoff
+    };
+
+    struct Lod {
+        size_t collisionCap;     // particles per grid cell that collide
+        int collisionInterval;   // resolve collisions every n-th step
+        int substeps;            // simulation steps per frame
+        float visibleFraction;   // share of particles drawn
+        int renderStride;        // draw every n-th visible particle
+    };
+
+    static constexpr int kDefaultLevel = 1; // the hand-tuned settings the game shipped with
+
+private:
+    Config config;
+    int level = kDefaultLevel;
+    int cooldown = 0;
+    uint64_t frame = 0;
+    int calmFrames = 0; // consecutive frames at or under the target
+    uint64_t retryAt[16] = {};
+    int backoff[16] = {};
+    char lastDecision[32] = "hold";
+
+public:
+    FrameGovernor();
+    explicit FrameGovernor(const Config& cfg);
+
+    // call once per frame; returns true if the level changed
+    bool update(const PerformanceMonitor& pm);
+    void reset();
+
+    int getLevel() const { return level; }
+    int getBackoff(const int lod) const { return backoff[lod]; }
+    static int getLevelCount();
+    const Lod& getLod() const;
+    Config& getConfig() { return config; }
+
+    // one overlay line: level, knob values, measured vs target
+    void describe(const PerformanceMonitor& pm, char* out, size_t size) const;
+};
+
+#endif
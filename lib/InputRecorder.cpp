@@ -0,0 +1,87 @@
+#include "InputRecorder.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+bool InputRecorder::open(const char* path, const uint32_t seed) {
+    close();
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "InputRecorder: cannot write " << path << std::endl;
+        return false;
+    }
+    InputStreamHeader header{};
+    memcpy(header.magic, "DODINPUT", 8);
+    header.version = kInputStreamVersion;
+    header.seed = seed;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    frames = 0;
+    return true;
+}
+
+void InputRecorder::close() {
+    if (!out.is_open())
+        return;
+    out.close();
+    pending.clear();
+}
+
+void InputRecorder::endFrame(const float dt) {
+    if (!out.is_open())
+        return;
+    const auto count = static_cast<uint16_t>(std::min<size_t>(pending.size(), UINT16_MAX));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(&dt), sizeof(dt));
+    if (count > 0)
+        out.write(reinterpret_cast<const char*>(pending.data()), static_cast<std::streamsize>(count * sizeof(InputEvent)));
+    pending.clear();
+    frames++;
+}
+
+bool InputReplay::open(const char* path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "InputReplay: cannot open " << path << std::endl;
+        return false;
+    }
+    stream.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    InputStreamHeader header{};
+    if (stream.size() < sizeof(header)) {
+        std::cerr << "InputReplay: " << path << " is truncated" << std::endl;
+        stream.clear();
+        return false;
+    }
+    memcpy(&header, stream.data(), sizeof(header));
+    if (memcmp(header.magic, "DODINPUT", 8) != 0 || header.version != kInputStreamVersion) {
+        std::cerr << "InputReplay: " << path << " is not a version " << kInputStreamVersion << " input stream" << std::endl;
+        stream.clear();
+        return false;
+    }
+    seed = header.seed;
+    cursor = sizeof(header);
+    frames = 0;
+    return true;
+}
+
+bool InputReplay::nextFrame(float& dt, std::vector<InputEvent>& events) {
+    events.clear();
+    constexpr size_t frameHeader = sizeof(uint16_t) + sizeof(float);
+    if (cursor + frameHeader > stream.size())
+        return false;
+
+    uint16_t count = 0;
+    memcpy(&count, stream.data() + cursor, sizeof(count));
+    memcpy(&dt, stream.data() + cursor + sizeof(count), sizeof(dt));
+    const size_t payload = count * sizeof(InputEvent);
+    if (cursor + frameHeader + payload > stream.size())
+        return false;
+
+    events.resize(count);
+    if (count > 0)
+        memcpy(events.data(), stream.data() + cursor + frameHeader, payload);
+    cursor += frameHeader + payload;
+    frames++;
+    return true;
+}
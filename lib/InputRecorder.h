@@ -0,0 +1,61 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_INPUTRECORDER_H
+#define DATAORIENTEDDESIGNINGAMEDEV_INPUTRECORDER_H
+
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+// Input stream layout (native byte order):
+//   InputStreamHeader, then per frame: uint16 eventCount, float dt, InputEvent[eventCount]
+constexpr uint32_t kInputStreamVersion = 1;
+
+struct InputStreamHeader {
+    char magic[8]; // "DODINPUT"
+    uint32_t version;
+    uint32_t seed; // RNG seed the session was played with
+};
+
+#pragma pack(push, 1)
+struct InputEvent {
+    SDL_Keycode key;
+    uint8_t down;
+};
+#pragma pack(pop)
+
+class InputRecorder {
+private:
+    std::ofstream out;
+    std::vector<InputEvent> pending; // key transitions of the current frame
+    size_t frames = 0;
+
+public:
+    ~InputRecorder() { close(); }
+
+    bool open(const char* path, uint32_t seed);
+    void close();
+    bool isOpen() const { return out.is_open(); }
+
+    void recordKey(SDL_Keycode key, bool down) { pending.push_back({key, static_cast<uint8_t>(down ? 1 : 0)}); }
+    void endFrame(float dt); // writes dt plus the keys recorded since the previous frame
+    size_t getFrameCount() const { return frames; }
+};
+
+class InputReplay {
+private:
+    std::vector<unsigned char> stream; // whole file, so playback does no I/O
+    size_t cursor = 0;
+    uint32_t seed = 0;
+    size_t frames = 0;
+
+public:
+    bool open(const char* path);
+    bool isOpen() const { return !stream.empty(); }
+    uint32_t getSeed() const { return seed; }
+    size_t getFrameCount() const { return frames; }
+
+    // false once the stream is exhausted
+    bool nextFrame(float& dt, std::vector<InputEvent>& events);
+};
+
+#endif
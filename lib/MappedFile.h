@@ -0,0 +1,32 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_MAPPEDFILE_H
+#define DATAORIENTEDDESIGNINGAMEDEV_MAPPEDFILE_H
+
+#include <cstddef>
+
+// Read/write private (copy-on-write) mapping of a whole file.
+// Writes through the mapping never reach the file on disk.
+class MappedFile {
+private:
+    void* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const char* path);
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    unsigned char* data() const { return static_cast<unsigned char*>(base); }
+    size_t size() const { return length; }
+};
+
+#endif
@@ -0,0 +1,40 @@
+#include "MemoryStats.h"
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+size_t getMemoryBytes() {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    if (!status.is_open())
+        return 0;
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.size() > 6 && line.compare(0, 6, "VmRSS:") == 0) {
+            const std::string value_str = line.substr(6);
+            char* endptr = nullptr;
+            const long value = strtol(value_str.c_str(), &endptr, 10); // kB
+            if (endptr != value_str.c_str() && value > 0)
+                return static_cast<size_t>(value) * 1024;
+        }
+    }
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), sizeof(pmc)))
+        return static_cast<size_t>(pmc.WorkingSetSize);
+#endif
+    return 0;
+}
+
+size_t getMemoryMB() {
+    return getMemoryBytes() / (1024 * 1024);
+}
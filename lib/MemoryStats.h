@@ -0,0 +1,10 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_MEMORYSTATS_H
+#define DATAORIENTEDDESIGNINGAMEDEV_MEMORYSTATS_H
+
+#include <cstddef>
+
+// Resident set size of this process, 0 where unsupported. No SDL, so tools can link it too.
+size_t getMemoryBytes();
+size_t getMemoryMB();
+
+#endif
@@ -1,17 +1,145 @@
 #include "Particles.h"
 #include "Utils.h"
+#include <algorithm>
 #include <cmath>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PARTICLES_SSE2 1
+#endif
 
-Particles::Particles(const int screen_width, const int screen_height, const int cell_size, const float sprite_w, const float sprite_h)
-    : w(sprite_w), h(sprite_h), screen_width(screen_width), screen_height(screen_height), cell_size(cell_size)
+// particles per block when the compact columns are unpacked for the float kernels;
+// blocks never straddle a chunk of either representation
+static constexpr size_t kCompactBlock = 1024;
+static_assert(ChunkedColumn<int16_t>::kChunkSize % kCompactBlock == 0 && ChunkedColumn<float>::kChunkSize % kCompactBlock == 0,
+              "compact blocks must tile the chunks");
+
+// int16 fixed point -> float, 8 lanes at a time
+static void unpackFixed(const int16_t* src, float* dst, const size_t count, const float scale)
+{
+    size_t i = 0;
+#ifdef PARTICLES_SSE2
+    const __m128 s = _mm_set1_ps(scale);
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16); // sign extend
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), s));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), s));
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = static_cast<float>(src[i]) * scale;
+}
+
+// float -> int16 fixed point, rounded to nearest and saturated
+static void packFixed(const float* src, int16_t* dst, const size_t count, const float scale)
+{
+    size_t i = 0;
+#ifdef PARTICLES_SSE2
+    const __m128 s = _mm_set1_ps(scale);
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i), s));
+        const __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 4), s));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        const float v = std::nearbyint(src[i] * scale);
+        dst[i] = static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, v)));
+    }
+}
+
+// Dither for packFixedDithered: an additive low-discrepancy sequence over the particle
+// index (kDitherStride) and the step (kDitherStep), so every particle sees offsets that are
+// evenly spread over [0, 1) as the steps go by.
+static constexpr double kDitherStride = 0.6180339887498949;
+static constexpr double kDitherStep = 0.7548776662466927;
+
+// float -> int16 fixed point for non-negative values, rounded down after adding the dither
+// (offset + i * kDitherStride) mod 1. The expected result is the exact value, so movement
+// below one fixed-point unit per step accumulates instead of being rounded away.
+static void packFixedDithered(const float* src, int16_t* dst, const size_t count, const float scale, const float offset)
+{
+    const auto stride = static_cast<float>(kDitherStride);
+    size_t i = 0;
+#ifdef PARTICLES_SSE2
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 lane = _mm_setr_ps(0.0f, stride, 2.0f * stride, 3.0f * stride);
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128 t0 = _mm_add_ps(_mm_set1_ps(offset + static_cast<float>(i) * stride), lane);
+        const __m128 t1 = _mm_add_ps(_mm_set1_ps(offset + static_cast<float>(i + 4) * stride), lane);
+        const __m128 d0 = _mm_sub_ps(t0, _mm_cvtepi32_ps(_mm_cvttps_epi32(t0))); // fractional part
+        const __m128 d1 = _mm_sub_ps(t1, _mm_cvtepi32_ps(_mm_cvttps_epi32(t1)));
+        const __m128i lo = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i), s), d0));
+        const __m128i hi = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), s), d1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        const float t = offset + static_cast<float>(i) * stride;
+        const float v = std::floor(src[i] * scale + (t - std::floor(t)));
+        dst[i] = static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, v)));
+    }
+}
+
+Particles::Particles(const int world_width, const int world_height, const int cell_size, const float sprite_w, const float sprite_h)
+    : w(sprite_w), h(sprite_h), cell_size(cell_size)
+{
+    setWorldSize(world_width, world_height);
+}
+
+void Particles::setWorldSize(const int width, const int height)
+{
+    world_width = width;
+    world_height = height;
+
+    // as many fractional bits as the world leaves free in an int16
+    int bits = 0;
+    while ((1 << bits) <= std::max(world_width, world_height))
+        ++bits;
+    pos_shift = std::max(0, 15 - bits);
+
+    grid_w = (world_width + cell_size - 1) / cell_size;
+    grid_h = (world_height + cell_size - 1) / cell_size;
+    grid.assign(grid_w * grid_h, {});
+}
+
+void Particles::setActiveRegion(const Camera& camera, const int interval)
+{
+    // one cell of margin so particles entering the view are already up to date
+    const auto margin = static_cast<float>(cell_size);
+    region_x0 = camera.x - margin;
+    region_y0 = camera.y - margin;
+    region_x1 = camera.x + camera.w + margin;
+    region_y1 = camera.y + camera.h + margin;
+    far_interval = std::max(1, interval);
+}
+
+bool Particles::isNear(const float px, const float py) const
 {
-    grid_w = (screen_width + cell_size - 1) / cell_size;
-    grid_h = (screen_height + cell_size - 1) / cell_size;
-    grid.resize(grid_w * grid_h);
+    return px >= region_x0 && px < region_x1 && py >= region_y0 && py < region_y1;
 }
 
 void Particles::addSprite(const float pos_x, const float pos_y, const float vel_x, const float vel_y)
 {
+    if (compact)
+    {
+        int16_t q[4];
+        const float pos[2] = {pos_x, pos_y};
+        const float vel[2] = {vel_x, vel_y};
+        packFixed(pos, q, 2, static_cast<float>(1 << pos_shift));
+        packFixed(vel, q + 2, 2, static_cast<float>(1 << kVelShift));
+        qx.push_back(q[0]);
+        qy.push_back(q[1]);
+        qvx.push_back(q[2]);
+        qvy.push_back(q[3]);
+        return;
+    }
     x.push_back(pos_x);
     y.push_back(pos_y);
     vx.push_back(vel_x);
@@ -24,11 +152,15 @@ void Particles::clearSprites()
     y.clear();
     vx.clear();
     vy.clear();
+    qx.clear();
+    qy.clear();
+    qvx.clear();
+    qvy.clear();
 }
 
 void Particles::doubleSprites(const size_t max_count)
 {
-    const size_t current = x.size();
+    const size_t current = getCount();
     const size_t target = std::min(max_count, current * 2);
 
     for (size_t i = current; i < target; ++i)
@@ -36,8 +168,8 @@ void Particles::doubleSprites(const size_t max_count)
         const float angle = randFloat(0.0f, 2.0f * static_cast<float>(M_PI));
         constexpr float speed = 300.0f;
         addSprite(
-            randFloat(0.0f, static_cast<float>(screen_width) - w),
-            randFloat(0.0f, static_cast<float>(screen_height) - h),
+            randFloat(0.0f, static_cast<float>(world_width) - w),
+            randFloat(0.0f, static_cast<float>(world_height) - h),
             cosf(angle) * speed,
             sinf(angle) * speed
         );
@@ -46,10 +178,18 @@ void Particles::doubleSprites(const size_t max_count)
 
 void Particles::halveSprites()
 {
-    const size_t current = x.size();
+    const size_t current = getCount();
     if (current > 1)
     {
         const size_t new_size = current / 2;
+        if (compact)
+        {
+            qx.resize(new_size);
+            qy.resize(new_size);
+            qvx.resize(new_size);
+            qvy.resize(new_size);
+            return;
+        }
         x.resize(new_size);
         y.resize(new_size);
         vx.resize(new_size);
@@ -57,93 +197,287 @@ void Particles::halveSprites()
     }
 }
 
-void Particles::update(const float dt)
+void Particles::setCompact(const bool enabled)
 {
-    const size_t count = x.size();
+    if (enabled == compact)
+        return;
 
-    // move particles
-    for (size_t i = 0; i < count; ++i)
+    const size_t count = getCount();
+    const float pos_scale = static_cast<float>(1 << pos_shift);
+    const float vel_scale = static_cast<float>(1 << kVelShift);
+    if (enabled)
     {
-        x[i] += vx[i] * dt;
-        y[i] += vy[i] * dt;
-    }
-
-    // screen bounds collision
-    for (size_t i = 0; i < count; ++i)
-    {
-        if (x[i] <= 0.0f) // left
-        {
-            x[i] = 0.0f;
-            vx[i] = fabsf(vx[i]);
-        }
-        if (y[i] <= 0.0f) // top
+        qx.resize(count);
+        qy.resize(count);
+        qvx.resize(count);
+        qvy.resize(count);
+        for (size_t base = 0; base < count; base += kCompactBlock)
         {
-            y[i] = 0.0f;
-            vy[i] = fabsf(vy[i]);
+            const size_t n = std::min(kCompactBlock, count - base);
+            packFixed(&x[base], &qx[base], n, pos_scale);
+            packFixed(&y[base], &qy[base], n, pos_scale);
+            packFixed(&vx[base], &qvx[base], n, vel_scale);
+            packFixed(&vy[base], &qvy[base], n, vel_scale);
         }
-        if (x[i] + w >= static_cast<float>(screen_width)) // right
+        x = ChunkedColumn<float>();
+        y = ChunkedColumn<float>();
+        vx = ChunkedColumn<float>();
+        vy = ChunkedColumn<float>();
+    }
+    else
+    {
+        x.resize(count);
+        y.resize(count);
+        vx.resize(count);
+        vy.resize(count);
+        for (size_t base = 0; base < count; base += kCompactBlock)
         {
-            x[i] = static_cast<float>(screen_width) - w;
-            vx[i] = -fabsf(vx[i]);
+            const size_t n = std::min(kCompactBlock, count - base);
+            unpackFixed(&qx[base], &x[base], n, 1.0f / pos_scale);
+            unpackFixed(&qy[base], &y[base], n, 1.0f / pos_scale);
+            unpackFixed(&qvx[base], &vx[base], n, 1.0f / vel_scale);
+            unpackFixed(&qvy[base], &vy[base], n, 1.0f / vel_scale);
         }
-        if (y[i] + h >= static_cast<float>(screen_height)) // bottom
+        qx = ChunkedColumn<int16_t>();
+        qy = ChunkedColumn<int16_t>();
+        qvx = ChunkedColumn<int16_t>();
+        qvy = ChunkedColumn<int16_t>();
+    }
+    compact = enabled;
+}
+
+// move along one axis and bounce off the world edges at 0 and max
+static inline void moveAxis(float& p, float& v, const float step, const float max)
+{
+    const float n = p + v * step;
+    const float speed = fabsf(v);
+    v = n >= max ? -speed : (n <= 0.0f ? speed : v);
+    p = std::min(std::max(n, 0.0f), max);
+}
+
+void Particles::moveAndBounce(float* __restrict px, float* __restrict py, float* __restrict pvx, float* __restrict pvy, const size_t count, const size_t first, const float dt) const
+{
+    const float max_x = static_cast<float>(world_width) - w;
+    const float max_y = static_cast<float>(world_height) - h;
+
+    // written without branches so it vectorizes
+    if (far_interval <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
         {
-            y[i] = static_cast<float>(screen_height) - h;
-            vy[i] = -fabsf(vy[i]);
+            moveAxis(px[i], pvx[i], dt, max_x);
+            moveAxis(py[i], pvy[i], dt, max_y);
         }
+        return;
     }
 
-    for (auto& cell : grid)
-        cell.clear();
-
-    // populate grid cells
+    // far particles take their turn every far_interval frames, staggered by index
+    const auto interval = static_cast<size_t>(far_interval);
+    const float far_dt = dt * static_cast<float>(far_interval);
     for (size_t i = 0; i < count; ++i)
     {
-        const int gx = static_cast<int>(x[i]) / cell_size;
-        const int gy = static_cast<int>(y[i]) / cell_size;
-        // out of bounds check
-        if (gx < 0 || gx >= grid_w || gy < 0 || gy >= grid_h)
-            continue;
-        const int index = gy * grid_w + gx;
+        const bool due = (first + i + frame) % interval == 0;
+        const float step = isNear(px[i], py[i]) ? dt : (due ? far_dt : 0.0f);
+        moveAxis(px[i], pvx[i], step, max_x);
+        moveAxis(py[i], pvy[i], step, max_y);
+    }
+}
+
+// grid collisions on either representation: P is float or int16 fixed point (shift
+// fractional bits), V is the matching velocity type
+template<typename P, typename V>
+void Particles::collide(const ChunkedColumn<P>& px, const ChunkedColumn<P>& py, ChunkedColumn<V>& pvx, ChunkedColumn<V>& pvy, const int shift, const P pw, const P ph)
+{
+    {
+        PhaseTimer::Scope scope(timer, PhaseTimer::Grid);
+        for (auto& cell : grid)
+            cell.clear();
 
-        if (index >= 0 && index < static_cast<int>(grid.size()))
-            grid[index].push_back(i);
+        // populate grid cells, one chunk at a time
+        for (size_t k = 0; k < px.chunkCount(); ++k)
+        {
+            const P* cx = px.chunk(k);
+            const P* cy = py.chunk(k);
+            const size_t first = k * ChunkedColumn<P>::kChunkSize;
+            const size_t length = px.chunkLength(k);
+            for (size_t j = 0; j < length; ++j)
+            {
+                const int gx = (static_cast<int>(cx[j]) >> shift) / cell_size;
+                const int gy = (static_cast<int>(cy[j]) >> shift) / cell_size;
+                // out of bounds check
+                if (gx < 0 || gx >= grid_w || gy < 0 || gy >= grid_h)
+                    continue;
+                const int index = gy * grid_w + gx;
+
+                if (index >= 0 && index < static_cast<int>(grid.size()))
+                    grid[index].push_back(first + j);
+            }
+        }
     }
 
-    for (auto& cell : grid)
+    // the grid is still needed for render culling on steps that skip collisions
+    if (frame % static_cast<uint32_t>(std::max(1, collision_interval)) != 0)
+        return;
+    PhaseTimer::Scope scope(timer, PhaseTimer::Collide);
+
+    // cells around the active region collide every frame, the rest take turns
+    const int near_x0 = static_cast<int>(std::floor(region_x0 / static_cast<float>(cell_size)));
+    const int near_y0 = static_cast<int>(std::floor(region_y0 / static_cast<float>(cell_size)));
+    const int near_x1 = static_cast<int>(std::floor(region_x1 / static_cast<float>(cell_size)));
+    const int near_y1 = static_cast<int>(std::floor(region_y1 / static_cast<float>(cell_size)));
+
+    ContactStream::Lane* lane = contacts ? &contacts->lane(0) : nullptr;
+    const float unit = 1.0f / static_cast<float>(1 << shift);
+
+    for (size_t c = 0; c < grid.size(); ++c)
     {
-        constexpr size_t kCollisionCapPerCell = 32; // limit for performance
+        const auto& cell = grid[c];
         if (cell.empty()) continue;
+        if (far_interval > 1)
+        {
+            const int gx = static_cast<int>(c) % grid_w;
+            const int gy = static_cast<int>(c) / grid_w;
+            const bool near = gx >= near_x0 && gx <= near_x1 && gy >= near_y0 && gy <= near_y1;
+            if (!near && (c + frame) % static_cast<size_t>(far_interval) != 0) continue;
+        }
 
         // check collisions within cell
-        const size_t localCount = std::min(cell.size(), kCollisionCapPerCell);
+        const size_t localCount = std::min(cell.size(), collision_cap);
         for (size_t i = 0; i < localCount; ++i)
         {
             const size_t a = cell[i];
+            // positions are read-only here, so a's stay in registers for the inner loop
+            const P ax = px[a];
+            const P ay = py[a];
 
             for (size_t j = i + 1; j < localCount; ++j)
             {
                 const size_t b = cell[j];
+                const P bx = px[b];
+                const P by = py[b];
                 // AABB collision check
                 const bool overlap =
-                    x[a] < x[b] + w &&
-                    x[a] + w > x[b] &&
-                    y[a] < y[b] + h &&
-                    y[a] + h > y[b];
+                    ax < bx + pw &&
+                    ax + pw > bx &&
+                    ay < by + ph &&
+                    ay + ph > by;
+
+                if (!overlap)
+                    continue;
+                std::swap(pvx[a], pvx[b]), std::swap(pvy[a], pvy[b]);
 
-                if (overlap)
-                    std::swap(vx[a], vx[b]), std::swap(vy[a], vy[b]);
+                if (lane)
+                {
+                    // normal along the axis of least overlap, pointing from a to b
+                    const float dx = static_cast<float>(bx - ax) * unit;
+                    const float dy = static_cast<float>(by - ay) * unit;
+                    const float ox = static_cast<float>(pw) * unit - std::fabs(dx);
+                    const float oy = static_cast<float>(ph) * unit - std::fabs(dy);
+                    if (ox < oy)
+                        lane->emit(static_cast<uint32_t>(a), static_cast<uint32_t>(b), dx < 0.0f ? -1.0f : 1.0f, 0.0f, ox);
+                    else
+                        lane->emit(static_cast<uint32_t>(a), static_cast<uint32_t>(b), 0.0f, dy < 0.0f ? -1.0f : 1.0f, oy);
+                }
             }
         }
     }
 }
 
-void Particles::render(SDL_Renderer* renderer, SDL_Texture* texture) const
+void Particles::update(const float dt)
+{
+    // substeps split the frame into shorter moves with a collision pass after each
+    const int steps = std::max(1, substeps);
+    const float step_dt = dt / static_cast<float>(steps);
+    if (contacts)
+        contacts->begin();
+    for (int s = 0; s < steps; ++s)
+    {
+        if (compact)
+            stepCompact(step_dt);
+        else
+            stepFloat(step_dt);
+        ++frame;
+    }
+    if (contacts)
+        contacts->merge();
+}
+
+void Particles::stepFloat(const float dt)
 {
-    const size_t count = x.size();
-    for (size_t i = 0; i < count; ++i)
     {
-        SDL_FRect dst{x[i], y[i], w, h};
-        SDL_RenderTexture(renderer, texture, nullptr, &dst);
+        PhaseTimer::Scope scope(timer, PhaseTimer::Move);
+        for (size_t k = 0; k < x.chunkCount(); ++k)
+            moveAndBounce(x.chunk(k), y.chunk(k), vx.chunk(k), vy.chunk(k), x.chunkLength(k), k * ChunkedColumn<float>::kChunkSize, dt);
     }
-}
\ No newline at end of file
+    collide(x, y, vx, vy, 0, w, h);
+}
+
+void Particles::stepCompact(const float dt)
+{
+    const size_t count = qx.size();
+    const float pos_scale = static_cast<float>(1 << pos_shift);
+    const float vel_scale = static_cast<float>(1 << kVelShift);
+
+    // unpack a cache-sized block, run the float kernel on it, pack it back
+    {
+        PhaseTimer::Scope scope(timer, PhaseTimer::Move);
+        alignas(64) float bx[kCompactBlock], by[kCompactBlock], bvx[kCompactBlock], bvy[kCompactBlock];
+        for (size_t base = 0; base < count; base += kCompactBlock)
+        {
+            const size_t n = std::min(kCompactBlock, count - base);
+            unpackFixed(&qx[base], bx, n, 1.0f / pos_scale);
+            unpackFixed(&qy[base], by, n, 1.0f / pos_scale);
+            unpackFixed(&qvx[base], bvx, n, 1.0f / vel_scale);
+            unpackFixed(&qvy[base], bvy, n, 1.0f / vel_scale);
+            moveAndBounce(bx, by, bvx, bvy, n, base, dt);
+            // dithered, or moves under half a unit per step would round back to where they started
+            const double phase = static_cast<double>(base) * kDitherStride + static_cast<double>(frame) * kDitherStep;
+            const auto offset = static_cast<float>(phase - std::floor(phase));
+            packFixedDithered(bx, &qx[base], n, pos_scale, offset);
+            packFixedDithered(by, &qy[base], n, pos_scale, offset < 0.5f ? offset + 0.5f : offset - 0.5f);
+            packFixed(bvx, &qvx[base], n, vel_scale);
+            packFixed(bvy, &qvy[base], n, vel_scale);
+        }
+    }
+
+    // collisions compare the fixed-point values directly
+    const auto qw = static_cast<int16_t>(std::lround(w * pos_scale));
+    const auto qh = static_cast<int16_t>(std::lround(h * pos_scale));
+    collide(qx, qy, qvx, qvy, pos_shift, qw, qh);
+}
+
+size_t Particles::render(SDL_Renderer* renderer, SDL_Texture* texture, const Camera& camera) const
+{
+    PhaseTimer::Scope scope(timer, PhaseTimer::Render);
+
+    // only the grid cells under the camera are visited; particles are binned by their
+    // top-left corner, so the range reaches one sprite up and left of the view
+    const auto cell = static_cast<float>(cell_size);
+    const int gx0 = std::max(0, static_cast<int>(std::floor((camera.x - w) / cell)));
+    const int gy0 = std::max(0, static_cast<int>(std::floor((camera.y - h) / cell)));
+    const int gx1 = std::min(grid_w - 1, static_cast<int>(std::floor((camera.x + camera.w) / cell)));
+    const int gy1 = std::min(grid_h - 1, static_cast<int>(std::floor((camera.y + camera.h) / cell)));
+
+    // LOD: a stable subset of the particles, decimated by render_stride
+    const auto count = static_cast<size_t>(static_cast<double>(getCount()) * std::min(1.0f, visible_fraction));
+    const auto stride = static_cast<size_t>(std::max(1, render_stride));
+    const float inv = 1.0f / static_cast<float>(1 << pos_shift);
+    size_t drawn = 0;
+    for (int gy = gy0; gy <= gy1; ++gy)
+    {
+        for (int gx = gx0; gx <= gx1; ++gx)
+        {
+            for (const size_t i : grid[gy * grid_w + gx])
+            {
+                if (i >= count || i % stride != 0) continue; // grid is from the last update
+                const float px = compact ? qx[i] * inv : x[i];
+                const float py = compact ? qy[i] * inv : y[i];
+                if (!camera.sees(px, py, w, h)) continue;
+                SDL_FRect dst{px - camera.x, py - camera.y, w, h};
+                SDL_RenderTexture(renderer, texture, nullptr, &dst);
+                ++drawn;
+            }
+        }
+    }
+    return drawn;
+}
@@ -2,35 +2,88 @@
 #define DATAORIENTEDDESIGNINGAMEDEV_PARTICLES_H
 
 #include <SDL3/SDL.h>
+#include <cstdint>
 #include <vector>
+#include "Camera.h"
+#include "ChunkedColumn.h"
+#include "ContactStream.h"
+#include "PhaseTimer.h"
 
+// Columns are chunked: growth never moves particles, and the kernels run chunk by chunk.
 struct Particles {
-    std::vector<float> x;
-    std::vector<float> y;
-    std::vector<float> vx;
-    std::vector<float> vy;
+    ChunkedColumn<float> x;
+    ChunkedColumn<float> y;
+    ChunkedColumn<float> vx;
+    ChunkedColumn<float> vy;
+
+    // compact mode: positions in fixed point with pos_shift fractional bits,
+    // velocities in 1/8 px/s steps. 8 bytes per particle instead of 16.
+    static constexpr int kVelShift = 3;
+    bool compact = false;
+    int32_t pos_shift;
+    ChunkedColumn<int16_t> qx;
+    ChunkedColumn<int16_t> qy;
+    ChunkedColumn<int16_t> qvx;
+    ChunkedColumn<int16_t> qvy;
 
     float w;
     float h;
-    int screen_width;
-    int screen_height;
+    // simulation bounds in world space, independent of the screen
+    int world_width;
+    int world_height;
 
     int cell_size;
     int grid_w;
     int grid_h;
     std::vector<std::vector<size_t>> grid;
 
-    Particles(int screen_width, int screen_height, int cell_size, float sprite_w, float sprite_h);
+    // reduced-rate simulation outside the active region (usually the camera view):
+    // far particles move every far_interval frames with a scaled step, far cells
+    // resolve collisions on a staggered schedule. 1 = everything every frame.
+    int far_interval = 1;
+    float region_x0 = 0.0f, region_y0 = 0.0f, region_x1 = 0.0f, region_y1 = 0.0f;
+    uint32_t frame = 0;
+
+    // LOD knobs (driven by FrameGovernor); the defaults are full quality
+    size_t collision_cap = 32;     // particles per cell that take part in collisions
+    int collision_interval = 1;    // resolve collisions every n-th step
+    int substeps = 1;              // steps per update
+    float visible_fraction = 1.0f; // share of the particles that is drawn
+    int render_stride = 1;         // draw every n-th of those
+
+    PhaseTimer* timer = nullptr;   // optional per-phase timing
+    // optional contact output: collisions go to lane 0 as particle index pairs,
+    // the stream is reset at the start of update() and merged at its end
+    ContactStream* contacts = nullptr;
+
+    Particles(int world_width, int world_height, int cell_size, float sprite_w, float sprite_h);
+
+    void setWorldSize(int width, int height);
+    void setActiveRegion(const Camera& camera, int interval);
 
     void addSprite(float pos_x, float pos_y, float vel_x, float vel_y);
     void clearSprites();
-    void doubleSprites(size_t max_count = 100000);
+    void doubleSprites(size_t max_count = SIZE_MAX);
     void halveSprites();
 
+    // converts the existing particles between float and fixed-point columns
+    void setCompact(bool enabled);
+    bool isCompact() const { return compact; }
+
     void update(float dt);
-    void render(SDL_Renderer* renderer, SDL_Texture* texture) const;
+    // draws the particles in the camera's grid cells, returns how many were drawn
+    size_t render(SDL_Renderer* renderer, SDL_Texture* texture, const Camera& camera) const;
+
+    size_t getCount() const { return compact ? qx.size() : x.size(); }
+
+private:
+    void stepFloat(float dt);
+    void stepCompact(float dt);
+    bool isNear(float px, float py) const;
+    void moveAndBounce(float* __restrict px, float* __restrict py, float* __restrict pvx, float* __restrict pvy, size_t count, size_t first, float dt) const;
 
-    size_t getCount() const { return x.size(); }
+    template<typename P, typename V>
+    void collide(const ChunkedColumn<P>& px, const ChunkedColumn<P>& py, ChunkedColumn<V>& pvx, ChunkedColumn<V>& pvy, int shift, P pw, P ph);
 };
 
-#endif
\ No newline at end of file
+#endif
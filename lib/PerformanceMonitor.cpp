@@ -3,18 +3,11 @@
 //
 
 #include <iostream>
-#include <fstream>
+#include <algorithm>
+#include <vector>
+#include <cmath>
 #include "PerformanceMonitor.h"
 
-#ifdef _WIN32
-#define WIN32_LEAN_AND_MEAN
-#ifndef NOMINMAX
-#define NOMINMAX
-#endif
-#include <windows.h>
-#include <psapi.h>
-#endif
-
 static void updateText(SDL_Renderer* renderer, TTF_Font* font, Text* text, const char* new_text, const SDL_Color color)
 {
     if (!new_text || strlen(new_text) == 0)
@@ -38,6 +31,31 @@ static void updateText(SDL_Renderer* renderer, TTF_Font* font, Text* text, const
     SDL_DestroySurface(surface);
 }
 
+// nearest-rank percentile of an ascending array
+static float percentileOf(const float* sorted, const size_t count, const double p)
+{
+    return sorted[static_cast<size_t>(p * static_cast<double>(count - 1) + 0.5)];
+}
+
+static float percentileOf(const std::vector<float>& sorted, const double p)
+{
+    return percentileOf(sorted.data(), sorted.size(), p);
+}
+
+// doubles the history buffer when full; false if it could not grow
+static bool growHistory(float** history, size_t* capacity, const size_t count)
+{
+    if (count < *capacity)
+        return true;
+    const size_t new_capacity = *capacity ? *capacity * 2 : 4096;
+    float* grown = static_cast<float*>(realloc(*history, new_capacity * sizeof(float)));
+    if (!grown)
+        return false;
+    *history = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
 static void DrawText(SDL_Renderer* renderer, const Text* textObj, const int x, const int y)
 {
     if (!renderer || !textObj || !textObj->texture) return;
@@ -45,35 +63,6 @@ static void DrawText(SDL_Renderer* renderer, const Text* textObj, const int x, c
     SDL_RenderTexture(renderer, textObj->texture, nullptr, &dst);
 }
 
-size_t getMemoryMB()
-{
-#ifdef __linux__
-    std::ifstream status("/proc/self/status");
-    if (!status.is_open())
-        return 0;
-    std::string line;
-    while (std::getline(status, line))
-    {
-        if (line.size() > 6 && line.substr(0, 6) == "VmRSS:") {
-            const std::string value_str = line.substr(6);
-            char* endptr = nullptr;
-            const long value = strtol(value_str.c_str(), &endptr, 10);
-            if (endptr != value_str.c_str() && value > 0) {
-                return static_cast<size_t>(value) / 1024;
-            }
-        }
-    }
-#elif defined(_WIN32)
-    PROCESS_MEMORY_COUNTERS_EX pmc;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), sizeof(pmc)))
-    {
-        const size_t rss_bytes = static_cast<size_t>(pmc.WorkingSetSize);
-        return rss_bytes / (1024 * 1024);
-    }
-#endif
-    return 0;
-}
-
 void PerformanceMonitor_Init(PerformanceMonitor* pm, SDL_Renderer* renderer, TTF_Font* font)
 {
     memset(pm, 0, sizeof(PerformanceMonitor));
@@ -97,21 +86,47 @@ void PerformanceMonitor_Update(PerformanceMonitor* pm, SDL_Renderer* renderer, T
     for (const float fps_sample : pm->fps_samples)
         sum += fps_sample;
     pm->avg_fps = sum / FPS_SAMPLES;
+    const float previous_ms = pm->frame_time_ms;
     pm->frame_time_ms = static_cast<float>(dt * 1000.0);
+    pm->jitter_ms = previous_ms > 0.0f ? fabsf(pm->frame_time_ms - previous_ms) : 0.0f;
+    pm->smoothed_jitter_ms += 0.1f * (pm->jitter_ms - pm->smoothed_jitter_ms);
+    pm->smoothed_frame_ms = (pm->smoothed_frame_ms > 0.0f)
+        ? pm->smoothed_frame_ms + 0.1f * (pm->frame_time_ms - pm->smoothed_frame_ms)
+        : pm->frame_time_ms;
 
     const size_t final_count = (pm->monitored_count > 0) ? pm->monitored_count : sprite_count;
+    const size_t mem_mb = getMemoryMB();
+
+    if (pm->record_history)
+    {
+        if (growHistory(&pm->frame_history, &pm->history_capacity, pm->history_count))
+            pm->frame_history[pm->history_count++] = pm->frame_time_ms;
+        pm->peak_memory_mb = std::max(pm->peak_memory_mb, mem_mb);
+    }
 
     char fps_line[64], frame_line[64], mem_line[64], sprite_line[64];
     snprintf(fps_line, sizeof(fps_line), "FPS: %.1f", pm->avg_fps);
-    snprintf(frame_line, sizeof(frame_line), "Frame: %.3f ms", pm->frame_time_ms);
+    snprintf(frame_line, sizeof(frame_line), "Frame: %.3f ms (busy %.3f, jitter %.3f)", pm->frame_time_ms, pm->busy_ms, pm->smoothed_jitter_ms);
 
-    const size_t mem_mb = getMemoryMB();
     snprintf(mem_line, sizeof(mem_line), "Memory: %zu MB", mem_mb);
     snprintf(sprite_line, sizeof(sprite_line), "Sprites: %zu", final_count);
     updateText(renderer, font, &pm->fps_text, fps_line, pm->color);
     updateText(renderer, font, &pm->frame_text, frame_line, pm->color);
     updateText(renderer, font, &pm->mem_text, mem_line, pm->color);
     updateText(renderer, font, &pm->sprite_count_text, sprite_line, pm->color);
+    if (pm->latency_samples > 0)
+    {
+        // distribution of the recent samples; one sample alone is too noisy to read
+        float recent[LATENCY_SAMPLES];
+        const size_t count = std::min<size_t>(pm->latency_samples, LATENCY_SAMPLES);
+        std::copy(pm->latency_recent, pm->latency_recent + count, recent);
+        std::sort(recent, recent + count);
+        char latency_line[96];
+        snprintf(latency_line, sizeof(latency_line), "Input latency: p50 %.2f | p95 %.2f | p99 %.2f ms",
+                 percentileOf(recent, count, 0.50), percentileOf(recent, count, 0.95), percentileOf(recent, count, 0.99));
+        updateText(renderer, font, &pm->latency_text, latency_line, pm->color);
+    }
+    updateText(renderer, font, &pm->status_text, pm->status_line, pm->color);
 }
 
 void PerformanceMonitor_Draw(const PerformanceMonitor* pm, SDL_Renderer* renderer)
@@ -120,12 +135,108 @@ void PerformanceMonitor_Draw(const PerformanceMonitor* pm, SDL_Renderer* rendere
     DrawText(renderer, &pm->frame_text, 10, 40);
     DrawText(renderer, &pm->mem_text, 10, 70);
     DrawText(renderer, &pm->sprite_count_text, 10,100);
+    if (pm->latency_samples > 0)
+        DrawText(renderer, &pm->latency_text, 10, 130);
+    if (pm->status_line[0] != '\0')
+        DrawText(renderer, &pm->status_text, 10, 160);
+}
+
+void PerformanceMonitor_RecordLatency(PerformanceMonitor* pm, const float queue_ms, const float update_ms, const float present_ms)
+{
+    pm->last_latency_ms = queue_ms + update_ms + present_ms;
+    pm->latency_samples++;
+    pm->latency_recent[pm->latency_index] = pm->last_latency_ms;
+    pm->latency_index = (pm->latency_index + 1) % LATENCY_SAMPLES;
+    pm->latency_queue_total_ms += queue_ms;
+    pm->latency_update_total_ms += update_ms;
+    pm->latency_present_total_ms += present_ms;
+    if (pm->record_history && growHistory(&pm->latency_history, &pm->latency_capacity, pm->latency_count))
+        pm->latency_history[pm->latency_count++] = pm->last_latency_ms;
+}
+
+void PerformanceMonitor_RecordBusy(PerformanceMonitor* pm, const float busy_ms)
+{
+    pm->busy_ms = busy_ms;
+    pm->smoothed_busy_ms = (pm->smoothed_busy_ms > 0.0f)
+        ? pm->smoothed_busy_ms + 0.1f * (busy_ms - pm->smoothed_busy_ms)
+        : busy_ms;
+    pm->busy_total_ms += busy_ms;
+    pm->busy_samples++;
+}
+
+void PerformanceMonitor_SetStatus(PerformanceMonitor* pm, const char* status)
+{
+    strncpy(pm->status_line, status ? status : "", sizeof(pm->status_line) - 1);
+    pm->status_line[sizeof(pm->status_line) - 1] = '\0';
+}
+
+void PerformanceMonitor_RecordHistory(PerformanceMonitor* pm, const bool enabled)
+{
+    pm->record_history = enabled;
+}
+
+void PerformanceMonitor_PrintSummary(const PerformanceMonitor* pm, const char* title)
+{
+    if (pm->history_count == 0)
+    {
+        printf("%s: no frames recorded\n", title);
+        return;
+    }
+    std::vector<float> sorted(pm->frame_history, pm->frame_history + pm->history_count);
+    std::sort(sorted.begin(), sorted.end());
+    const auto percentile = [&sorted](const double p) { return percentileOf(sorted, p); };
+
+    double total_ms = 0.0;
+    for (const float ms : sorted)
+        total_ms += ms;
+    const double avg_ms = total_ms / static_cast<double>(sorted.size());
+
+    printf("=== %s ===\n", title);
+    printf("frames:      %zu\n", sorted.size());
+    printf("total:       %.1f ms\n", total_ms);
+    printf("avg FPS:     %.1f\n", avg_ms > 0.0 ? 1000.0 / avg_ms : 0.0);
+    printf("frame ms:    avg %.3f | min %.3f | p50 %.3f | p95 %.3f | p99 %.3f | max %.3f\n",
+           avg_ms, sorted.front(), percentile(0.50), percentile(0.95), percentile(0.99), sorted.back());
+    if (pm->busy_samples > 0)
+        printf("busy ms:     avg %.3f (without frame limiter / vsync waits)\n", pm->busy_total_ms / static_cast<double>(pm->busy_samples));
+
+    // frame-to-frame jitter, in recorded order
+    if (pm->history_count > 1)
+    {
+        std::vector<float> jitter(pm->history_count - 1);
+        for (size_t i = 1; i < pm->history_count; ++i)
+            jitter[i - 1] = fabsf(pm->frame_history[i] - pm->frame_history[i - 1]);
+        std::sort(jitter.begin(), jitter.end());
+        double jitter_total = 0.0;
+        for (const float ms : jitter)
+            jitter_total += ms;
+        const auto at = [&jitter](const double p) { return percentileOf(jitter, p); };
+        printf("jitter ms:   avg %.3f | p50 %.3f | p95 %.3f | p99 %.3f | max %.3f\n",
+               jitter_total / static_cast<double>(jitter.size()), at(0.50), at(0.95), at(0.99), jitter.back());
+    }
+
+    if (pm->latency_count > 0)
+    {
+        std::vector<float> latency(pm->latency_history, pm->latency_history + pm->latency_count);
+        std::sort(latency.begin(), latency.end());
+        const double n = static_cast<double>(pm->latency_samples);
+        printf("input latency ms (%zu frames): avg %.3f | p50 %.3f | p95 %.3f | p99 %.3f | max %.3f\n",
+               latency.size(), (pm->latency_queue_total_ms + pm->latency_update_total_ms + pm->latency_present_total_ms) / n,
+               percentileOf(latency, 0.50), percentileOf(latency, 0.95), percentileOf(latency, 0.99), latency.back());
+        printf("  avg stages:  queue %.3f | update %.3f | render+present %.3f\n",
+               pm->latency_queue_total_ms / n, pm->latency_update_total_ms / n, pm->latency_present_total_ms / n);
+    }
+    printf("peak memory: %zu MB\n", pm->peak_memory_mb);
 }
 
 void PerformanceMonitor_Destroy(const PerformanceMonitor* pm)
 {
+    free(pm->frame_history);
+    free(pm->latency_history);
     if (pm->fps_text.texture) SDL_DestroyTexture(pm->fps_text.texture);
     if (pm->frame_text.texture) SDL_DestroyTexture(pm->frame_text.texture);
     if (pm->mem_text.texture) SDL_DestroyTexture(pm->mem_text.texture);
     if (pm->sprite_count_text.texture) SDL_DestroyTexture(pm->sprite_count_text.texture);
+    if (pm->latency_text.texture) SDL_DestroyTexture(pm->latency_text.texture);
+    if (pm->status_text.texture) SDL_DestroyTexture(pm->status_text.texture);
 }
\ No newline at end of file
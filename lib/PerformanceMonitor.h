@@ -6,8 +6,10 @@
 #define DATAORIENTEDDESIGNINGAMEDEV_PERFORMANCEMONITOR_H
 
 #define FPS_SAMPLES 100
+#define LATENCY_SAMPLES 128
 #include <SDL3/SDL.h>
 #include <SDL3_ttf/SDL_ttf.h>
+#include "MemoryStats.h"
 
 typedef struct
 {
@@ -22,6 +24,15 @@ typedef struct
     int fps_index;
     float avg_fps;
     float frame_time_ms;
+    float smoothed_frame_ms; // exponential moving average, for controllers like FrameGovernor
+    float jitter_ms;          // |frame time - previous frame time|
+    float smoothed_jitter_ms;
+    // work per frame: frame start -> presented, without the frame limiter's wait or a
+    // vsync block; frame_time_ms above is wall clock and includes them
+    float busy_ms;
+    float smoothed_busy_ms; // exponential moving average, what FrameGovernor steers on
+    double busy_total_ms;
+    size_t busy_samples;
     Uint64 last_counter;
     Uint64 freq;
 
@@ -29,15 +40,41 @@ typedef struct
     Text frame_text;
     Text mem_text;
     Text sprite_count_text;
+    Text latency_text;
+    Text status_text;
+    char status_line[128]; // extra overlay line set by the game, empty = hidden
     SDL_Color color;
     size_t monitored_count;
+
+    // per-frame history for end-of-run summaries (off unless requested)
+    bool record_history;
+    float* frame_history;
+    size_t history_count;
+    size_t history_capacity;
+    size_t peak_memory_mb;
+
+    // input-to-photon latency, one sample per presented frame that consumed input
+    float last_latency_ms;
+    size_t latency_samples;
+    float latency_recent[LATENCY_SAMPLES]; // ring of the latest samples, for overlay percentiles
+    int latency_index;
+    float* latency_history; // kept while record_history is on
+    size_t latency_count;
+    size_t latency_capacity;
+    double latency_queue_total_ms;   // event timestamp -> poll
+    double latency_update_total_ms;  // poll -> end of update
+    double latency_present_total_ms; // end of update -> SDL_RenderPresent returned
 }PerformanceMonitor;
 
-size_t getMemoryMB();
 static void updateText(SDL_Renderer* renderer, TTF_Font* font, Text* text, const char* new_text, SDL_Color color);
 void PerformanceMonitor_Init(PerformanceMonitor* pm, SDL_Renderer* renderer, TTF_Font* font);
 void PerformanceMonitor_Update(PerformanceMonitor* pm, SDL_Renderer* renderer, TTF_Font* font, size_t sprite_count);
 void PerformanceMonitor_Draw(const PerformanceMonitor* pm, SDL_Renderer* renderer);
+void PerformanceMonitor_RecordLatency(PerformanceMonitor* pm, float queue_ms, float update_ms, float present_ms);
+void PerformanceMonitor_RecordBusy(PerformanceMonitor* pm, float busy_ms);
+void PerformanceMonitor_SetStatus(PerformanceMonitor* pm, const char* status);
+void PerformanceMonitor_RecordHistory(PerformanceMonitor* pm, bool enabled);
+void PerformanceMonitor_PrintSummary(const PerformanceMonitor* pm, const char* title);
 void PerformanceMonitor_Destroy(const PerformanceMonitor* pm);
 
 #endif //DATAORIENTEDDESIGNINGAMEDEV_PERFORMANCEMONITOR_H
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_PHASETIMER_H
+#define DATAORIENTEDDESIGNINGAMEDEV_PHASETIMER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+// Wall-clock time per frame phase, accumulated across frames so the particle and
+// ECS screensaver paths can be compared phase by phase.
+class PhaseTimer {
+public:
+    enum Phase { Spawn, Move, Grid, Collide, Render, kPhaseCount };
+
+    // times the enclosing block; a null timer makes it a no-op
+    class Scope {
+        PhaseTimer* timer;
+        Phase phase;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        Scope(PhaseTimer* t, const Phase p) : timer(t), phase(p) {
+            if (timer) start = std::chrono::steady_clock::now();
+        }
+        ~Scope() {
+            if (timer) timer->add(phase, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+private:
+    double current[kPhaseCount] = {};
+    double last[kPhaseCount] = {};
+    double total[kPhaseCount] = {};
+    size_t frames = 0;
+
+    static const char* name(const int phase) {
+        static const char* const names[kPhaseCount] = {"spawn", "move", "grid", "collide", "render"};
+        return names[phase];
+    }
+
+public:
+    void add(const Phase phase, const double ms) {
+        current[phase] += ms;
+        total[phase] += ms;
+    }
+
+    void endFrame() {
+        for (int p = 0; p < kPhaseCount; ++p) {
+            last[p] = current[p];
+            current[p] = 0.0;
+        }
+        frames++;
+    }
+
+    void reset() { *this = PhaseTimer(); }
+    size_t getFrames() const { return frames; }
+    double getLast(const Phase phase) const { return last[phase]; }
+    double getAverage(const Phase phase) const { return frames ? total[phase] / static_cast<double>(frames) : 0.0; }
+
+    // last frame, one overlay line
+    void describe(char* out, const size_t size) const {
+        snprintf(out, size, "ms: move %.2f | grid %.2f | collide %.2f | render %.2f",
+                 last[Move], last[Grid], last[Collide], last[Render]);
+    }
+
+    void print(const char* title) const {
+        if (frames == 0)
+            return;
+        printf("--- %s phases (avg ms over %zu frames) ---\n", title, frames);
+        double sum = 0.0;
+        for (int p = 0; p < kPhaseCount; ++p) {
+            printf("%-8s %.3f\n", name(p), getAverage(static_cast<Phase>(p)));
+            sum += getAverage(static_cast<Phase>(p));
+        }
+        printf("%-8s %.3f\n", "total", sum);
+    }
+};
+
+#endif
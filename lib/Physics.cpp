@@ -0,0 +1,233 @@
+#include "Physics.h"
+#include <algorithm>
+#include <cmath>
+
+// floor without the libm call (positions are far inside int range)
+static int32_t cellCoord(const float v) {
+    const auto i = static_cast<int32_t>(v);
+    return i - (v < static_cast<float>(i));
+}
+
+uint32_t PhysicsSystem::bucket(const int32_t x, const int32_t y) const {
+    const uint32_t h = (static_cast<uint32_t>(x) * 73856093u) ^ (static_cast<uint32_t>(y) * 19349663u);
+    return h & bucketMask;
+}
+
+void PhysicsSystem::gather(ECSWorld& world) {
+    auto* transforms = world.getComponentArray<Transform>();
+    auto* balls = world.getComponentArray<Ball>();
+    auto* paddles = world.getComponentArray<Paddle>();
+    const uint64_t tv = transforms ? transforms->getVersion() : 0;
+    const uint64_t bv = balls ? balls->getVersion() : 0;
+    const uint64_t pv = paddles ? paddles->getVersion() : 0;
+    if (tv == transformVersion && bv == ballVersion && pv == paddleVersion)
+        return; // no entity gained or lost a relevant component
+
+    ballSlots.clear();
+    paddleSlots.clear();
+    if (transforms) {
+        if (balls) {
+            ballSlots.reserve(balls->size());
+            for (size_t i = 0; i < balls->size(); ++i) {
+                const size_t slot = transforms->indexOf(balls->getEntityAt(i));
+                if (slot != ComponentArrayTyped<Transform>::npos)
+                    ballSlots.push_back(static_cast<uint32_t>(slot));
+            }
+            // pool order keeps the scatter/gather passes walking memory forward
+            std::sort(ballSlots.begin(), ballSlots.end());
+        }
+        if (paddles) {
+            for (size_t i = 0; i < paddles->size(); ++i) {
+                const size_t slot = transforms->indexOf(paddles->getEntityAt(i));
+                if (slot != ComponentArrayTyped<Transform>::npos)
+                    paddleSlots.push_back(static_cast<uint32_t>(slot));
+            }
+        }
+    }
+    transformVersion = tv;
+    ballVersion = bv;
+    paddleVersion = pv;
+}
+
+void PhysicsSystem::buildBroadphase(const Transform* transforms, const EntityID* entities) {
+    const size_t n = ballSlots.size();
+    size_t buckets = 64;
+    while (buckets < n)
+        buckets <<= 1;
+    bucketMask = static_cast<uint32_t>(buckets - 1);
+
+    const float inv = 1.0f / config.cellSize;
+    bucketStart.assign(buckets + 1, 0);
+    bucketOf.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const Transform& b = transforms[ballSlots[i]];
+        bucketOf[i] = bucket(cellCoord((b.x + b.w * 0.5f) * inv), cellCoord((b.y + b.h * 0.5f) * inv));
+        bucketStart[bucketOf[i] + 1]++;
+    }
+    for (size_t k = 0; k < buckets; ++k)
+        bucketStart[k + 1] += bucketStart[k];
+
+    // counting sort by bucket
+    cursor.assign(bucketStart.begin(), bucketStart.end() - 1);
+    order.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        order[cursor[bucketOf[i]]++] = static_cast<uint32_t>(i);
+
+    px.resize(n); py.resize(n); hw.resize(n); hh.resize(n); bvx.resize(n); bvy.resize(n);
+    cx.resize(n); cy.resize(n); ballEntity.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        const uint32_t slot = ballSlots[order[k]];
+        const Transform& b = transforms[slot];
+        ballEntity[k] = entities[slot];
+        hw[k] = b.w * 0.5f; hh[k] = b.h * 0.5f;
+        px[k] = b.x + hw[k]; py[k] = b.y + hh[k];
+        bvx[k] = b.vx; bvy[k] = b.vy;
+        cx[k] = cellCoord(px[k] * inv);
+        cy[k] = cellCoord(py[k] * inv);
+    }
+}
+
+void PhysicsSystem::collideBalls() {
+    float* const __restrict x = px.data();
+    float* const __restrict y = py.data();
+    float* const __restrict vx = bvx.data();
+    float* const __restrict vy = bvy.data();
+    const float* const rx = hw.data();
+    const float* const ry = hh.data();
+    ContactStream::Lane& lane = contacts.lane(BallContacts);
+
+    // ball a is kept in registers while it is tested against a run of candidates
+    const auto collideRun = [&](const uint32_t a, const uint32_t begin, const uint32_t end, const int32_t gx, const int32_t gy) {
+        float ax = x[a], ay = y[a], avx = vx[a], avy = vy[a];
+        const float ra = (rx[a] + ry[a]) * 0.5f;
+        for (uint32_t b = begin; b < end; ++b) {
+            const float dx = x[b] - ax;
+            const float dy = y[b] - ay;
+            const float dist2 = dx * dx + dy * dy;
+            const float rsum = ra + (rx[b] + ry[b]) * 0.5f;
+            // buckets can hold more than one cell, so the cell has to match too
+            if (dist2 >= rsum * rsum || dist2 <= 1e-8f || cx[b] != gx || cy[b] != gy)
+                continue;
+
+            const float dist = std::sqrt(dist2);
+            const float nx = dx / dist, ny = dy / dist;
+            // separate equally, then swap the normal velocity components (equal-mass elastic)
+            const float push = (rsum - dist) * 0.5f;
+            ax -= nx * push; ay -= ny * push;
+            x[b] += nx * push; y[b] += ny * push;
+            const float rel = (vx[b] - avx) * nx + (vy[b] - avy) * ny;
+            if (rel < 0.0f) {
+                avx += rel * nx; avy += rel * ny;
+                vx[b] -= rel * nx; vy[b] -= rel * ny;
+            }
+            lane.emit(ballEntity[a], ballEntity[b], nx, ny, rsum - dist);
+        }
+        x[a] = ax; y[a] = ay; vx[a] = avx; vy[a] = avy;
+    };
+
+    // half neighbourhood so every cell pair is visited once
+    constexpr int32_t kNeighbours[4][2] = {{1, -1}, {1, 0}, {1, 1}, {0, 1}};
+    const auto cap = static_cast<uint32_t>(config.maxPerCell);
+    const size_t buckets = static_cast<size_t>(bucketMask) + 1;
+    for (size_t k = 0; k < buckets; ++k) {
+        const uint32_t begin = bucketStart[k];
+        const uint32_t end = std::min(bucketStart[k + 1], begin + cap);
+        for (uint32_t a = begin; a < end; ++a) {
+            collideRun(a, a + 1, end, cx[a], cy[a]);
+            for (const auto& n : kNeighbours) {
+                const int32_t gx = cx[a] + n[0], gy = cy[a] + n[1];
+                const uint32_t nk = bucket(gx, gy);
+                const uint32_t nbegin = bucketStart[nk];
+                collideRun(a, nbegin, std::min(bucketStart[nk + 1], nbegin + cap), gx, gy);
+            }
+        }
+    }
+}
+
+void PhysicsSystem::collidePaddles(const Transform* transforms, const EntityID* entities) {
+    ContactStream::Lane& lane = contacts.lane(PaddleContacts);
+    const float inv = 1.0f / config.cellSize;
+    const float margin = config.cellSize * 0.5f; // ball centres can sit half a cell outside the paddle
+    for (const uint32_t slot : paddleSlots) {
+        const Transform& pt = transforms[slot];
+        const int32_t x0 = cellCoord((pt.x - margin) * inv);
+        const int32_t x1 = cellCoord((pt.x + pt.w + margin) * inv);
+        const int32_t y0 = cellCoord((pt.y - margin) * inv);
+        const int32_t y1 = cellCoord((pt.y + pt.h + margin) * inv);
+        for (int32_t gy = y0; gy <= y1; ++gy) {
+            for (int32_t gx = x0; gx <= x1; ++gx) {
+                const uint32_t k = bucket(gx, gy);
+                for (uint32_t b = bucketStart[k]; b < bucketStart[k + 1]; ++b) {
+                    if (cx[b] != gx || cy[b] != gy)
+                        continue;
+                    const bool hit = pt.x < px[b] + hw[b] && pt.x + pt.w > px[b] - hw[b] &&
+                                     pt.y < py[b] + hh[b] && pt.y + pt.h > py[b] - hh[b]; // AABB check
+                    if (hit) {
+                        lane.emit(ballEntity[b], entities[slot], 0.0f, 1.0f, py[b] + hh[b] - pt.y); // normal from ball into paddle
+                        py[b] = pt.y - hh[b]; // place ball above paddle
+                        bvy[b] = -std::fabs(bvy[b]); // reflect upward
+                        bvx[b] += pt.vx * config.paddleSpin; // spin for paddle motion
+                    }
+                }
+            }
+        }
+    }
+}
+
+void PhysicsSystem::update(ECSWorld& world, const float dt, const float worldW, const float worldH) {
+    contacts.begin();
+    auto* pool = world.getComponentArray<Transform>();
+    if (!pool)
+        return;
+    gather(world);
+
+    // writes are marked per element so resting entities keep their change tick
+    Transform* transforms = pool->dataUntracked();
+    const size_t count = pool->size();
+
+    // integrate everything that moves
+    for (size_t i = 0; i < count; ++i) {
+        if (transforms[i].vx == 0.0f && transforms[i].vy == 0.0f)
+            continue;
+        transforms[i].x += transforms[i].vx * dt;
+        transforms[i].y += transforms[i].vy * dt;
+        pool->markChanged(i);
+    }
+
+    // paddles stay on screen
+    for (const uint32_t slot : paddleSlots) {
+        Transform& t = transforms[slot];
+        const float clamped = std::max(0.0f, std::min(t.x, worldW - t.w));
+        if (clamped != t.x) {
+            t.x = clamped;
+            pool->markChanged(slot);
+        }
+    }
+
+    // ball bounds
+    for (const uint32_t slot : ballSlots) {
+        Transform& b = transforms[slot];
+        if (b.y <= 0.0f) { b.y = 0.0f; b.vy = std::fabs(b.vy); } // top
+        if (b.y + b.h >= worldH) { b.y = worldH - b.h; b.vy = -std::fabs(b.vy); } // bottom
+        if (b.x <= 0.0f) { b.x = 0.0f; b.vx = std::fabs(b.vx); } // left
+        if (b.x + b.w >= worldW) { b.x = worldW - b.w; b.vx = -std::fabs(b.vx); } // right
+    }
+
+    if (ballSlots.empty())
+        return;
+
+    buildBroadphase(transforms, pool->entities());
+    collideBalls();
+    collidePaddles(transforms, pool->entities());
+    contacts.merge();
+
+    // scatter the resolved state back into the pool (balls are always in motion)
+    const size_t n = ballSlots.size();
+    for (size_t k = 0; k < n; ++k) {
+        const uint32_t slot = ballSlots[order[k]];
+        Transform& b = transforms[slot];
+        b.x = px[k] - hw[k]; b.y = py[k] - hh[k];
+        b.vx = bvx[k]; b.vy = bvy[k];
+        pool->markChanged(slot);
+    }
+}
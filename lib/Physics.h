@@ -0,0 +1,63 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_PHYSICS_H
+#define DATAORIENTEDDESIGNINGAMEDEV_PHYSICS_H
+
+#include <cstdint>
+#include <vector>
+#include "ContactStream.h"
+#include "Entity.h"
+
+// ECS physics for the Pong entities: integration, world bounds, a spatial-hash
+// broadphase and ball-ball / ball-paddle narrowphase. Works on the dense Transform
+// pool; per-frame state lives in SoA scratch buffers that are reused between frames.
+class PhysicsSystem {
+public:
+    struct Config {
+        float cellSize = 40.0f;        // spatial hash cell, should be >= the largest ball
+        size_t maxPerCell = 16;        // balls per cell that take part in collisions (like kCollisionCapPerCell)
+        float paddleSpin = 0.25f;      // fraction of paddle velocity transferred on hit
+    };
+
+    // contact lanes; pairs are entity ids, a paddle contact is (ball, paddle)
+    enum ContactLane { BallContacts, PaddleContacts, kContactLaneCount };
+
+private:
+    Config config;
+
+    // Transform pool indices, rebuilt only when a pool changes structurally
+    std::vector<uint32_t> ballSlots;
+    std::vector<uint32_t> paddleSlots;
+    uint64_t transformVersion = ~0ull, ballVersion = ~0ull, paddleVersion = ~0ull;
+
+    // broadphase: balls counting-sorted by hash bucket
+    std::vector<uint32_t> bucketStart; // size buckets + 1
+    std::vector<uint32_t> cursor;
+    std::vector<uint32_t> bucketOf;    // per ball
+    std::vector<uint32_t> order;       // ball ids sorted by bucket
+    uint32_t bucketMask = 0;
+
+    // ball state in bucket order for the narrowphase (centres and half extents)
+    std::vector<float> px, py, hw, hh, bvx, bvy;
+    std::vector<int32_t> cx, cy;
+    std::vector<EntityID> ballEntity;
+
+    ContactStream contacts{kContactLaneCount};
+
+    void gather(ECSWorld& world);
+    void buildBroadphase(const Transform* transforms, const EntityID* entities);
+    void collideBalls();
+    void collidePaddles(const Transform* transforms, const EntityID* entities);
+    uint32_t bucket(int32_t x, int32_t y) const;
+
+public:
+    PhysicsSystem() = default;
+    explicit PhysicsSystem(const Config& cfg) : config(cfg) {}
+
+    void update(ECSWorld& world, float dt, float worldW, float worldH);
+
+    size_t getBallCount() const { return ballSlots.size(); }
+    size_t getContactCount() const { return contacts.size(); }
+    const ContactStream& getContacts() const { return contacts; } // this frame's, merged
+    Config& getConfig() { return config; }
+};
+
+#endif
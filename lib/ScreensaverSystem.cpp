@@ -0,0 +1,139 @@
+#include "ScreensaverSystem.h"
+#include "CommandBuffer.h"
+#include "Utils.h"
+#include <algorithm>
+#include <cmath>
+
+ScreensaverSystem::ScreensaverSystem(const Config& cfg) : config(cfg) {
+    gridW = (static_cast<int>(config.worldW) + config.cellSize - 1) / config.cellSize;
+    gridH = (static_cast<int>(config.worldH) + config.cellSize - 1) / config.cellSize;
+    grid.resize(static_cast<size_t>(gridW) * gridH);
+}
+
+size_t ScreensaverSystem::getCount(const ECSWorld& world) const {
+    const auto* transforms = world.getComponentArray<Transform>();
+    return transforms ? transforms->size() : 0;
+}
+
+void ScreensaverSystem::spawn(ECSWorld& world, const size_t count, const int textureID) {
+    PhaseTimer::Scope scope(timer, PhaseTimer::Spawn);
+    const float size = config.spriteSize;
+    world.createEntitiesWith<Transform, Renderable>(count,
+        [this, size](EntityID, Span<Transform> transforms, Span<Renderable>) {
+            for (size_t i = 0; i < transforms.size(); ++i) {
+                const float angle = randFloat(0.0f, 2.0f * static_cast<float>(M_PI));
+                constexpr float speed = 300.0f;
+                const float x = randFloat(0.0f, config.worldW - size);
+                const float y = randFloat(0.0f, config.worldH - size);
+                transforms[i] = Transform(x, y, std::cos(angle) * speed, std::sin(angle) * speed, size, size);
+            }
+        },
+        Transform(), Renderable(textureID));
+}
+
+void ScreensaverSystem::doubleEntities(ECSWorld& world, const size_t maxCount, const int textureID) {
+    const size_t current = getCount(world);
+    spawn(world, std::min(maxCount, current * 2) - std::min(maxCount, current), textureID);
+}
+
+void ScreensaverSystem::halveEntities(ECSWorld& world) {
+    PhaseTimer::Scope scope(timer, PhaseTimer::Spawn);
+    const auto* transforms = world.getComponentArray<Transform>();
+    if (!transforms || transforms->size() <= 1)
+        return;
+    // destroying while walking the pool would reorder it, so defer to a command buffer
+    CommandBuffer commands(world);
+    for (size_t i = transforms->size() / 2; i < transforms->size(); ++i)
+        commands.destroy(transforms->getEntityAt(i));
+    commands.apply();
+}
+
+// move along one axis and bounce off the world edges at 0 and max (as in Particles)
+static inline void moveAxis(float& p, float& v, const float step, const float max) {
+    const float n = p + v * step;
+    const float speed = std::fabs(v);
+    v = n >= max ? -speed : (n <= 0.0f ? speed : v);
+    p = std::min(std::max(n, 0.0f), max);
+}
+
+void ScreensaverSystem::update(ECSWorld& world, const float dt) {
+    auto* pool = world.getComponentArray<Transform>();
+    if (!pool)
+        return;
+    const size_t count = pool->size();
+    Transform* transforms = pool->data(); // everything moves, so mark the whole pool changed
+
+    {
+        PhaseTimer::Scope scope(timer, PhaseTimer::Move);
+        for (size_t i = 0; i < count; ++i) {
+            Transform& t = transforms[i];
+            moveAxis(t.x, t.vx, dt, config.worldW - t.w);
+            moveAxis(t.y, t.vy, dt, config.worldH - t.h);
+        }
+    }
+
+    {
+        PhaseTimer::Scope scope(timer, PhaseTimer::Grid);
+        for (auto& cell : grid)
+            cell.clear();
+        for (size_t i = 0; i < count; ++i) {
+            const int gx = static_cast<int>(transforms[i].x) / config.cellSize;
+            const int gy = static_cast<int>(transforms[i].y) / config.cellSize;
+            if (gx < 0 || gx >= gridW || gy < 0 || gy >= gridH)
+                continue;
+            grid[gy * gridW + gx].push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    PhaseTimer::Scope scope(timer, PhaseTimer::Collide);
+    for (const auto& cell : grid) {
+        const size_t localCount = std::min(cell.size(), config.collisionCap);
+        for (size_t i = 0; i < localCount; ++i) {
+            Transform& a = transforms[cell[i]];
+            for (size_t j = i + 1; j < localCount; ++j) {
+                Transform& b = transforms[cell[j]];
+                const bool overlap = a.x < b.x + b.w && a.x + a.w > b.x &&
+                                     a.y < b.y + b.h && a.y + a.h > b.y; // AABB check
+                if (overlap) {
+                    std::swap(a.vx, b.vx);
+                    std::swap(a.vy, b.vy);
+                }
+            }
+        }
+    }
+}
+
+size_t ScreensaverSystem::render(const ECSWorld& world, SDL_Renderer* renderer, const std::vector<SDL_Texture*>& textures, const Camera& camera) const {
+    PhaseTimer::Scope scope(timer, PhaseTimer::Render);
+    const auto* pool = world.getComponentArray<Transform>();
+    const auto* renderables = world.getComponentArray<Renderable>();
+    if (!pool || !renderables)
+        return 0;
+
+    // same culling as Particles::render: only the cells under the camera
+    const auto cell = static_cast<float>(config.cellSize);
+    const float size = config.spriteSize;
+    const int gx0 = std::max(0, static_cast<int>(std::floor((camera.x - size) / cell)));
+    const int gy0 = std::max(0, static_cast<int>(std::floor((camera.y - size) / cell)));
+    const int gx1 = std::min(gridW - 1, static_cast<int>(std::floor((camera.x + camera.w) / cell)));
+    const int gy1 = std::min(gridH - 1, static_cast<int>(std::floor((camera.y + camera.h) / cell)));
+
+    const Transform* transforms = pool->data();
+    const EntityID* owners = pool->entities();
+    size_t drawn = 0;
+    for (int gy = gy0; gy <= gy1; ++gy) {
+        for (int gx = gx0; gx <= gx1; ++gx) {
+            for (const uint32_t i : grid[gy * gridW + gx]) {
+                if (i >= pool->size()) continue; // grid is from the last update
+                const Transform& t = transforms[i];
+                if (!camera.sees(t.x, t.y, t.w, t.h)) continue;
+                const Renderable* r = renderables->readComponent(owners[i]);
+                if (!r || r->textureID < 0 || r->textureID >= static_cast<int>(textures.size())) continue;
+                const SDL_FRect dst{t.x - camera.x, t.y - camera.y, t.w, t.h};
+                SDL_RenderTexture(renderer, textures[r->textureID], nullptr, &dst);
+                ++drawn;
+            }
+        }
+    }
+    return drawn;
+}
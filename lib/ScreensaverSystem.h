@@ -0,0 +1,47 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_SCREENSAVERSYSTEM_H
+#define DATAORIENTEDDESIGNINGAMEDEV_SCREENSAVERSYSTEM_H
+
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <vector>
+#include "Camera.h"
+#include "Entity.h"
+#include "PhaseTimer.h"
+
+// The screensaver workload (spawn, double/halve, bounds, grid collisions, culled
+// render) on ECS entities with Transform + Renderable. Mirrors Particles step for
+// step so the bespoke SoA and the ECS path can be timed on identical work.
+class ScreensaverSystem {
+public:
+    struct Config {
+        float worldW = 1280.0f;
+        float worldH = 720.0f;
+        int cellSize = 64;
+        float spriteSize = 32.0f;
+        size_t collisionCap = 32; // same as Particles::collision_cap
+    };
+
+private:
+    Config config;
+    int gridW = 0;
+    int gridH = 0;
+    std::vector<std::vector<uint32_t>> grid; // Transform pool indices binned by top-left corner
+
+public:
+    PhaseTimer* timer = nullptr; // optional per-phase timing
+
+    explicit ScreensaverSystem(const Config& cfg);
+
+    void spawn(ECSWorld& world, size_t count, int textureID);
+    void doubleEntities(ECSWorld& world, size_t maxCount, int textureID);
+    void halveEntities(ECSWorld& world);
+
+    void update(ECSWorld& world, float dt);
+    // draws the entities in the camera's grid cells, returns how many were drawn
+    size_t render(const ECSWorld& world, SDL_Renderer* renderer, const std::vector<SDL_Texture*>& textures, const Camera& camera) const;
+
+    size_t getCount(const ECSWorld& world) const;
+    const Config& getConfig() const { return config; }
+};
+
+#endif
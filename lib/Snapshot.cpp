@@ -0,0 +1,276 @@
+#include "Snapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <iostream>
+
+static uint64_t alignUp(const uint64_t value, const uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void SnapshotWriter::addBlob(const char* name, const void* data, const uint32_t elemSize, const uint64_t count) {
+    PendingBlob blob{};
+    strncpy(blob.section.name, name, sizeof(blob.section.name) - 1);
+    blob.section.elemSize = elemSize;
+    blob.section.count = count;
+    if (count > 0)
+        blob.pieces.push_back({data, count * elemSize});
+    blobs.push_back(std::move(blob));
+}
+
+void SnapshotWriter::addParticles(const Particles& particles, const char* prefix) {
+    auto meta = std::make_unique<ParticlesMeta>();
+    meta->w = particles.w;
+    meta->h = particles.h;
+    meta->world_width = particles.world_width;
+    meta->world_height = particles.world_height;
+    meta->cell_size = particles.cell_size;
+    meta->count = static_cast<uint32_t>(particles.getCount());
+
+    char name[40];
+    snprintf(name, sizeof(name), "%s.meta", prefix);
+    addBlob(name, meta.get(), sizeof(ParticlesMeta), 1);
+    particleMetas.push_back(std::move(meta));
+
+    if (particles.isCompact()) {
+        // fixed-point columns go out as-is, tagged with their fractional bits
+        snprintf(name, sizeof(name), "%s.pos_shift", prefix);
+        addBlob(name, &particles.pos_shift, sizeof(int32_t), 1);
+        const ChunkedColumn<int16_t>* columns[4] = {&particles.qx, &particles.qy, &particles.qvx, &particles.qvy};
+        const char* suffixes[4] = {"x", "y", "vx", "vy"};
+        for (int c = 0; c < 4; ++c) {
+            snprintf(name, sizeof(name), "%s.%s", prefix, suffixes[c]);
+            addColumn(name, *columns[c]);
+        }
+        return;
+    }
+    snprintf(name, sizeof(name), "%s.x", prefix);
+    addColumn(name, particles.x);
+    snprintf(name, sizeof(name), "%s.y", prefix);
+    addColumn(name, particles.y);
+    snprintf(name, sizeof(name), "%s.vx", prefix);
+    addColumn(name, particles.vx);
+    snprintf(name, sizeof(name), "%s.vy", prefix);
+    addColumn(name, particles.vy);
+}
+
+void SnapshotWriter::addWorld(const ECSWorld& world) {
+    worldMeta.nextEntityID = world.getNextEntityID();
+    addBlob("world.meta", &worldMeta, sizeof(WorldMeta), 1);
+}
+
+bool SnapshotWriter::write(const char* path) const {
+    SnapshotHeader header{};
+    memcpy(header.magic, "DODSNAP", 8);
+    header.version = kSnapshotVersion;
+    header.sectionCount = static_cast<uint32_t>(blobs.size());
+    header.byteOrder = kSnapshotByteOrder;
+    header.alignment = kSnapshotAlignment;
+
+    // lay out blobs after the section table, each on its own aligned offset
+    std::vector<SnapshotSection> table;
+    table.reserve(blobs.size());
+    uint64_t offset = alignUp(sizeof(SnapshotHeader) + blobs.size() * sizeof(SnapshotSection), kSnapshotAlignment);
+    for (const auto& blob : blobs) {
+        SnapshotSection section = blob.section;
+        section.offset = offset;
+        table.push_back(section);
+        offset = alignUp(offset + section.count * section.elemSize, kSnapshotAlignment);
+    }
+    header.fileSize = offset;
+
+    // Written next to the target and renamed over it: a loaded snapshot may still be mapped
+    // (and its columns adopted) from path, so truncating it in place would pull those pages
+    // away from under the game and from under this writer.
+    const std::string tmp = std::string(path) + ".tmp";
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Snapshot: cannot write " << tmp << std::endl;
+        return false;
+    }
+
+    static const char zeros[kSnapshotAlignment] = {};
+    uint64_t written = 0;
+    const auto put = [&](const void* data, const uint64_t bytes) {
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        written += bytes;
+    };
+    const auto padTo = [&](const uint64_t target) {
+        while (written < target)
+            put(zeros, std::min<uint64_t>(target - written, sizeof(zeros)));
+    };
+
+    put(&header, sizeof(header));
+    if (!table.empty())
+        put(table.data(), table.size() * sizeof(SnapshotSection));
+    for (size_t i = 0; i < blobs.size(); ++i) {
+        padTo(table[i].offset);
+        for (const Piece& piece : blobs[i].pieces)
+            put(piece.data, piece.bytes);
+    }
+    padTo(header.fileSize);
+
+    out.flush();
+    const bool good = out.good();
+    out.close();
+    if (!good || out.fail()) {
+        std::cerr << "Snapshot: write failed for " << tmp << std::endl;
+        std::remove(tmp.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    std::remove(path); // rename does not replace on Windows
+#endif
+    if (std::rename(tmp.c_str(), path) != 0) {
+        std::cerr << "Snapshot: cannot replace " << path << std::endl;
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SnapshotReader::open(const char* path) {
+    close();
+    auto mapped = std::make_shared<MappedFile>();
+    if (!mapped->open(path))
+        return false;
+
+    if (mapped->size() < sizeof(SnapshotHeader)) {
+        std::cerr << "Snapshot: " << path << " is truncated" << std::endl;
+        return false;
+    }
+    const auto* header = reinterpret_cast<const SnapshotHeader*>(mapped->data());
+    if (memcmp(header->magic, "DODSNAP", 8) != 0 || header->byteOrder != kSnapshotByteOrder) {
+        std::cerr << "Snapshot: " << path << " is not a snapshot for this platform" << std::endl;
+        return false;
+    }
+    if (header->version != kSnapshotVersion) {
+        std::cerr << "Snapshot: unsupported version " << header->version << " (expected " << kSnapshotVersion << ")" << std::endl;
+        return false;
+    }
+    if (header->fileSize > mapped->size() ||
+        sizeof(SnapshotHeader) + static_cast<uint64_t>(header->sectionCount) * sizeof(SnapshotSection) > mapped->size()) {
+        std::cerr << "Snapshot: " << path << " is truncated" << std::endl;
+        return false;
+    }
+
+    const auto* table = reinterpret_cast<const SnapshotSection*>(mapped->data() + sizeof(SnapshotHeader));
+    for (uint32_t i = 0; i < header->sectionCount; ++i) {
+        const SnapshotSection& s = table[i];
+        // divide instead of multiplying: a crafted count * elemSize must not wrap around
+        const uint64_t room = s.offset <= mapped->size() ? mapped->size() - s.offset : 0;
+        if (s.offset % kSnapshotAlignment != 0 || s.offset > mapped->size() ||
+            (s.elemSize != 0 && s.count > room / s.elemSize)) {
+            std::cerr << "Snapshot: section " << i << " is out of bounds" << std::endl;
+            return false;
+        }
+    }
+
+    file = std::move(mapped);
+    sections = table;
+    sectionCount = header->sectionCount;
+    return true;
+}
+
+void SnapshotReader::close() {
+    file.reset();
+    sections = nullptr;
+    sectionCount = 0;
+}
+
+bool SnapshotReader::validEntities(const EntityID* entities, const size_t count, const EntityID next, const char* pool) {
+    std::vector<EntityID> sorted(entities, entities + count);
+    std::sort(sorted.begin(), sorted.end());
+    // ids are handed out from 1 up to the restored nextEntityID
+    if (!sorted.empty() && (sorted.front() == 0 || sorted.back() >= next)) {
+        std::cerr << "Snapshot: pool " << pool << " has entity ids outside the saved world" << std::endl;
+        return false;
+    }
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+        std::cerr << "Snapshot: pool " << pool << " lists an entity twice" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+const SnapshotSection* SnapshotReader::find(const char* name) const {
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        if (strncmp(sections[i].name, name, sizeof(sections[i].name)) == 0)
+            return &sections[i];
+    }
+    return nullptr;
+}
+
+bool SnapshotReader::loadParticles(Particles& particles, const char* prefix) const {
+    char name[40];
+    size_t metaCount = 0;
+    snprintf(name, sizeof(name), "%s.meta", prefix);
+    const ParticlesMeta* meta = get<const ParticlesMeta>(name, metaCount);
+    if (!meta || metaCount != 1 || meta->world_width <= 0 || meta->world_height <= 0 || meta->cell_size <= 0)
+        return false;
+
+    const char* suffixes[4] = {"x", "y", "vx", "vy"};
+    size_t shiftCount = 0;
+    snprintf(name, sizeof(name), "%s.pos_shift", prefix);
+    if (const int32_t* shift = get<const int32_t>(name, shiftCount)) {
+        // int16 positions hold at most 15 fractional bits
+        if (shiftCount != 1 || *shift < 0 || *shift > 15) {
+            std::cerr << "Snapshot: invalid pos_shift in " << prefix << std::endl;
+            return false;
+        }
+        // compact snapshot: adopt the fixed-point columns instead
+        size_t counts[4] = {};
+        int16_t* columns[4] = {};
+        for (int c = 0; c < 4; ++c) {
+            snprintf(name, sizeof(name), "%s.%s", prefix, suffixes[c]);
+            columns[c] = get<int16_t>(name, counts[c]);
+            if (!columns[c] || counts[c] != meta->count)
+                return false;
+        }
+        particles.clearSprites();
+        particles.setCompact(true);
+        particles.cell_size = meta->cell_size; // the grid is rebuilt for it below
+        particles.setWorldSize(meta->world_width, meta->world_height);
+        particles.pos_shift = *shift;
+        particles.w = meta->w;
+        particles.h = meta->h;
+        particles.qx.adopt(columns[0], meta->count, file);
+        particles.qy.adopt(columns[1], meta->count, file);
+        particles.qvx.adopt(columns[2], meta->count, file);
+        particles.qvy.adopt(columns[3], meta->count, file);
+        return true;
+    }
+
+    size_t counts[4] = {};
+    float* columns[4] = {};
+    for (int c = 0; c < 4; ++c) {
+        snprintf(name, sizeof(name), "%s.%s", prefix, suffixes[c]);
+        columns[c] = get<float>(name, counts[c]);
+        if (!columns[c] || counts[c] != meta->count)
+            return false;
+    }
+
+    // the columns reference the mapping directly; pages are faulted in on first touch
+    particles.clearSprites();
+    particles.setCompact(false);
+    particles.cell_size = meta->cell_size;
+    particles.setWorldSize(meta->world_width, meta->world_height);
+    particles.w = meta->w;
+    particles.h = meta->h;
+    particles.x.adopt(columns[0], meta->count, file);
+    particles.y.adopt(columns[1], meta->count, file);
+    particles.vx.adopt(columns[2], meta->count, file);
+    particles.vy.adopt(columns[3], meta->count, file);
+    return true;
+}
+
+bool SnapshotReader::loadWorld(ECSWorld& world) const {
+    size_t metaCount = 0;
+    const WorldMeta* meta = get<const WorldMeta>("world.meta", metaCount);
+    if (!meta || metaCount != 1)
+        return false;
+    world.clear();
+    world.setNextEntityID(meta->nextEntityID);
+    return true;
+}
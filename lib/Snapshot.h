@@ -0,0 +1,186 @@
+#ifndef DATAORIENTEDDESIGNINGAMEDEV_SNAPSHOT_H
+#define DATAORIENTEDDESIGNINGAMEDEV_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "ECS.h"
+#include "MappedFile.h"
+#include "Particles.h"
+
+// Binary snapshot layout (native byte order, version checked on load):
+//   SnapshotHeader | SnapshotSection[sectionCount] | blobs...
+// Every blob starts on a page boundary so mapped columns can be used in place.
+constexpr uint32_t kSnapshotVersion = 1;
+constexpr uint32_t kSnapshotAlignment = 4096;
+constexpr uint32_t kSnapshotByteOrder = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8]; // "DODSNAP"
+    uint32_t version;
+    uint32_t sectionCount;
+    uint32_t byteOrder;
+    uint32_t alignment;
+    uint64_t fileSize;
+};
+
+struct SnapshotSection {
+    char name[40];
+    uint32_t elemSize;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t offset; // from start of file
+};
+
+static_assert(sizeof(SnapshotHeader) == 32, "snapshot header layout changed");
+static_assert(sizeof(SnapshotSection) == 64, "snapshot section layout changed");
+
+struct ParticlesMeta {
+    float w, h;
+    int32_t world_width, world_height;
+    int32_t cell_size;
+    uint32_t count;
+};
+
+struct WorldMeta {
+    EntityID nextEntityID;
+    uint32_t reserved;
+};
+
+// Bytes of a component that carry its data. Trivially copyable components are stored
+// as-is and adopted in place on load; components deriving from the polymorphic
+// Component base are stored without their vtable pointer and copied on load.
+template<typename T>
+struct ComponentPayload {
+    static_assert(std::is_trivially_copyable<T>::value || std::is_base_of<Component, T>::value,
+                  "snapshot components must be trivially copyable or derive from Component");
+    static constexpr size_t offset = std::is_trivially_copyable<T>::value ? 0 : sizeof(Component);
+    static constexpr size_t size = sizeof(T) - offset;
+};
+
+class SnapshotWriter {
+private:
+    // a blob is written from one or more contiguous pieces (e.g. the chunks of a column)
+    struct Piece {
+        const void* data;
+        uint64_t bytes;
+    };
+    struct PendingBlob {
+        SnapshotSection section;
+        std::vector<Piece> pieces;
+    };
+    std::vector<PendingBlob> blobs;
+    std::vector<std::unique_ptr<std::vector<unsigned char>>> scratch; // gathered pool data
+    std::vector<std::unique_ptr<ParticlesMeta>> particleMetas;
+    WorldMeta worldMeta{};
+
+public:
+    // data is referenced, not copied, until write() returns
+    void addBlob(const char* name, const void* data, uint32_t elemSize, uint64_t count);
+
+    // chunked column, written as one contiguous section
+    template<typename T>
+    void addColumn(const char* name, const ChunkedColumn<T>& column) {
+        addBlob(name, nullptr, sizeof(T), 0);
+        PendingBlob& blob = blobs.back();
+        blob.section.count = column.size();
+        for (size_t k = 0; k < column.chunkCount(); ++k)
+            blob.pieces.push_back({column.chunk(k), column.chunkLength(k) * sizeof(T)});
+    }
+
+    void addParticles(const Particles& particles, const char* prefix = "particles");
+    void addWorld(const ECSWorld& world);
+
+    template<typename T>
+    void addComponentPool(ECSWorld& world, const char* name) {
+        ComponentArrayTyped<T>* pool = world.getComponentArray<T>();
+        const size_t count = pool ? pool->size() : 0;
+
+        auto entities = std::make_unique<std::vector<unsigned char>>(count * sizeof(EntityID));
+        auto payload = std::make_unique<std::vector<unsigned char>>(count * ComponentPayload<T>::size);
+        for (size_t i = 0; i < count; ++i) {
+            const EntityID entity = pool->getEntityAt(i);
+            std::memcpy(entities->data() + i * sizeof(EntityID), &entity, sizeof(EntityID));
+            std::memcpy(payload->data() + i * ComponentPayload<T>::size,
+                        reinterpret_cast<const unsigned char*>(pool->getComponentAt(i)) + ComponentPayload<T>::offset,
+                        ComponentPayload<T>::size);
+        }
+
+        char section[40];
+        snprintf(section, sizeof(section), "pool.%s.entities", name);
+        addBlob(section, entities->data(), sizeof(EntityID), count);
+        snprintf(section, sizeof(section), "pool.%s.data", name);
+        addBlob(section, payload->data(), static_cast<uint32_t>(ComponentPayload<T>::size), count);
+
+        scratch.push_back(std::move(entities));
+        scratch.push_back(std::move(payload));
+    }
+
+    bool write(const char* path) const;
+};
+
+class SnapshotReader {
+private:
+    std::shared_ptr<MappedFile> file; // shared with every column adopted from it
+    const SnapshotSection* sections = nullptr;
+    uint32_t sectionCount = 0;
+
+    // every id in [1, next) and none twice, so a stale file cannot alias live entities
+    static bool validEntities(const EntityID* entities, size_t count, EntityID next, const char* pool);
+
+public:
+    bool open(const char* path);
+    void close();
+    bool isOpen() const { return file != nullptr; }
+
+    const SnapshotSection* find(const char* name) const;
+
+    // typed view of a section, nullptr if missing or the element size differs
+    template<typename T>
+    T* get(const char* name, size_t& count, const uint32_t elemSize = sizeof(T)) const {
+        const SnapshotSection* s = find(name);
+        if (!s || s->elemSize != elemSize)
+            return nullptr;
+        count = static_cast<size_t>(s->count);
+        return reinterpret_cast<T*>(file->data() + s->offset);
+    }
+
+    // adopts the mapped x/y/vx/vy columns in place (zero-copy)
+    bool loadParticles(Particles& particles, const char* prefix = "particles") const;
+    bool loadWorld(ECSWorld& world) const;
+
+    template<typename T>
+    bool loadComponentPool(ECSWorld& world, const char* name) const {
+        char section[40];
+        size_t entityCount = 0, dataCount = 0;
+        snprintf(section, sizeof(section), "pool.%s.entities", name);
+        const EntityID* entities = get<const EntityID>(section, entityCount);
+        snprintf(section, sizeof(section), "pool.%s.data", name);
+        unsigned char* payload = get<unsigned char>(section, dataCount, static_cast<uint32_t>(ComponentPayload<T>::size));
+        if (!entities || !payload || entityCount != dataCount)
+            return false;
+        if (!validEntities(entities, entityCount, world.getNextEntityID(), name))
+            return false;
+
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            if (!world.getComponentArray<T>() || world.getComponentArray<T>()->size() == 0) {
+                world.adoptComponents<T>(reinterpret_cast<T*>(payload), entities, entityCount, file);
+                return true;
+            }
+        }
+
+        world.reserveComponents<T>(entityCount);
+        for (size_t i = 0; i < entityCount; ++i) {
+            T value{};
+            std::memcpy(reinterpret_cast<unsigned char*>(&value) + ComponentPayload<T>::offset,
+                        payload + i * ComponentPayload<T>::size, ComponentPayload<T>::size);
+            world.addComponent<T>(entities[i], value);
+        }
+        return true;
+    }
+};
+
+#endif
@@ -1,12 +1,20 @@
 #ifndef DATAORIENTEDDESIGNINGAMEDEV_UTILS_H
 #define DATAORIENTEDDESIGNINGAMEDEV_UTILS_H
 
+#include <cstdint>
 #include <random>
 
-inline float randFloat(float a, const float b) {
+inline std::mt19937& randEngine() {
     static std::mt19937 rng(std::random_device{}());
+    return rng;
+}
+
+// fixed seeds make spawning reproducible (input record/replay)
+inline void seedRandom(const uint32_t seed) { randEngine().seed(seed); }
+
+inline float randFloat(float a, const float b) {
     std::uniform_real_distribution<float> dist(a, b);
-    return dist(rng);
+    return dist(randEngine());
 }
 
 #endif
\ No newline at end of file
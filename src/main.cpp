@@ -2,19 +2,30 @@
 #include <cmath>
 #include "../lib/Engine.h"
 #include "../lib/Particles.h"
+#include "../lib/Camera.h"
+#include "../lib/CommandBuffer.h"
 #include "../lib/Entity.h"
+#include "../lib/FrameGovernor.h"
+#include "../lib/PhaseTimer.h"
+#include "../lib/Physics.h"
+#include "../lib/ScreensaverSystem.h"
+#include "../lib/Snapshot.h"
 #include "../lib/Utils.h"
 
 #define SCREEN_WIDTH 1280
 #define SCREEN_HEIGHT 720
 #define SPRITE_SIZE 32.0f
-#define MAX_SPRITES 100000
+#define MAX_SPRITES (1 << 24) // chunked particle columns grow without copying
+#define MAX_BALLS 100000
+#define BALL_SIZE 20.0f
+#define CAMERA_SPEED 900.0f
+#define SNAPSHOT_PATH "snapshot.dod"
 
-enum class GameMode { MENU, SCREENSAVER, ECS_DEMO };
+enum class GameMode { MENU, SCREENSAVER, ECS_DEMO, ECS_SCREENSAVER };
 
 static void spawnRandom(Particles& m, const int count) {
-    const float maxX = static_cast<float>(m.screen_width) - SPRITE_SIZE;
-    const float maxY = static_cast<float>(m.screen_height) - SPRITE_SIZE;
+    const float maxX = static_cast<float>(m.world_width) - SPRITE_SIZE;
+    const float maxY = static_cast<float>(m.world_height) - SPRITE_SIZE;
     for (int i = 0; i < count; ++i) {
         const float angle = randFloat(0.0f, 2.0f * static_cast<float>(M_PI));
         constexpr float speed = 300.0f;
@@ -25,52 +36,186 @@ static void spawnRandom(Particles& m, const int count) {
 
 class Game : public GameEngine {
 private:
-    GameMode currentMode; // Menu, Screensaver, ECS Pong game
-    Particles manager;
+    GameMode currentMode; // Menu, Screensaver, ECS Pong game, ECS screensaver
+    Particles manager; // screensaver world, worldScale screens in each direction
+    Camera camera;
+    int worldScale;
+    int farInterval = 1; // reduced simulation rate outside the view
+    FrameGovernor governor;
+    bool governed = false; // adaptive LOD for the screensaver
+    ContactStream particleContacts; // screensaver collisions, refilled every update
     ECSWorld ecsWorld;
+    PhysicsSystem physics;
+    size_t paddleHits = 0;
+    // draw rects mirrored from the Transform pool: only entries written since the last
+    // frame are refreshed (change ticks), a structural change rebuilds them all
+    std::vector<SDL_FRect> ecsRects;
+    uint64_t ecsRectsVersion = ~0ull;
+    uint32_t ecsSeenTick = 0;
+
+    // the screensaver workload on ECS entities, for comparison with Particles
+    ECSWorld screensaverWorld;
+    ScreensaverSystem screensaverSystem;
+    PhaseTimer particleTimer, ecsTimer;
 
     EntityID paddle{};
     EntityID ball{};
 
     bool upPressed = false, downPressed = false;
-    bool onePressed = false, twoPressed = false;
+    bool onePressed = false, twoPressed = false, threePressed = false;
+    bool savePressed = false, loadPressed = false;
+    bool compactPressed = false;
+    bool governorPressed = false;
 
     float screenW() const { return static_cast<float>(getScreenWidth()); }
     float screenH() const { return static_cast<float>(getScreenHeight()); }
 
 public:
-    Game(const int w, const int h)
+    Game(const int w, const int h, const int scale = 1)
         : GameEngine(w, h, "DraganBall"),
           currentMode(GameMode::MENU),
-          manager(w, h, 64, SPRITE_SIZE, SPRITE_SIZE) {}
+          manager(w * scale, h * scale, 64, SPRITE_SIZE, SPRITE_SIZE),
+          camera(static_cast<float>(w), static_cast<float>(h)),
+          worldScale(scale),
+          screensaverSystem(ScreensaverSystem::Config{static_cast<float>(w * scale), static_cast<float>(h * scale), 64, SPRITE_SIZE, 32}) {
+        manager.timer = &particleTimer;
+        manager.contacts = &particleContacts;
+        screensaverSystem.timer = &ecsTimer;
+    }
 
     bool setup() { return initialize("../assets/fonts/Roboto.ttf", {"../assets/img/dragan.png"}); }
 
-    void initScreensaver() { manager.clearSprites(); spawnRandom(manager, 1000); }
+    void initScreensaver() { initScreensaver(1000 * static_cast<size_t>(worldScale * worldScale)); } // same density at any world size
+    void initScreensaver(const size_t count) {
+        PhaseTimer::Scope scope(&particleTimer, PhaseTimer::Spawn);
+        manager.clearSprites();
+        spawnRandom(manager, static_cast<int>(count));
+    }
+    void initECSScreensaver(const size_t count) {
+        screensaverWorld.clear();
+        screensaverSystem.spawn(screensaverWorld, count, 0);
+    }
+
+    // scripted run of one screensaver path with a fixed entity count
+    void benchmarkScreensaver(const GameMode mode, const size_t count) {
+        currentMode = mode;
+        if (mode == GameMode::ECS_SCREENSAVER) initECSScreensaver(count);
+        else initScreensaver(count);
+    }
+    void setCompactParticles(const bool enabled) { manager.setCompact(enabled); }
+    void setFarInterval(const int interval) { farInterval = interval; }
+    void setFrameBudget(const float ms) { governor.getConfig().targetMs = ms; setGoverned(true); }
+
+    void setGoverned(const bool enabled) {
+        governed = enabled;
+        governor.reset();
+        applyLod(FrameGovernor::Lod{32, 1, 1, 1.0f, 1}); // the ungoverned defaults
+        if (!governed) setOverlayStatus("");
+    }
+
+    void applyLod(const FrameGovernor::Lod& lod) {
+        manager.collision_cap = lod.collisionCap;
+        manager.collision_interval = lod.collisionInterval;
+        manager.substeps = lod.substeps;
+        manager.visible_fraction = lod.visibleFraction;
+        manager.render_stride = lod.renderStride;
+    }
+
+    // one governor step per frame, decisions shown in the overlay
+    void updateGovernor() {
+        if (!governed) return;
+        if (governor.update(getPerformance())) applyLod(governor.getLod());
+        char status[128];
+        governor.describe(getPerformance(), status, sizeof(status));
+        setOverlayStatus(status);
+    }
+
+    // writes the particle columns and every ECS pool into one snapshot file
+    bool saveSnapshot(const char* path) {
+        SnapshotWriter writer;
+        writer.addParticles(manager);
+        writer.addWorld(ecsWorld);
+        writer.addComponentPool<Transform>(ecsWorld, "Transform");
+        writer.addComponentPool<Renderable>(ecsWorld, "Renderable");
+        writer.addComponentPool<Paddle>(ecsWorld, "Paddle");
+        writer.addComponentPool<Ball>(ecsWorld, "Ball");
+        return writer.write(path);
+    }
+
+    // maps the snapshot; particle columns and POD component pools are adopted in place
+    bool loadSnapshot(const char* path) {
+        SnapshotReader reader;
+        if (!reader.open(path) || !reader.loadParticles(manager)) {
+            std::cerr << "Snapshot load failed: " << path << std::endl;
+            return false;
+        }
+        if (reader.loadWorld(ecsWorld)) {
+            const bool pools = reader.loadComponentPool<Transform>(ecsWorld, "Transform") &&
+                               reader.loadComponentPool<Renderable>(ecsWorld, "Renderable") &&
+                               reader.loadComponentPool<Paddle>(ecsWorld, "Paddle") &&
+                               reader.loadComponentPool<Ball>(ecsWorld, "Ball");
+            if (!pools) {
+                std::cerr << "Snapshot ECS pools rejected, starting with an empty world: " << path << std::endl;
+                ecsWorld.clear(); // no half-restored entities
+            }
+            const auto paddles = ecsWorld.getEntitiesWith<Paddle>();
+            paddle = paddles.empty() ? EntityID{} : paddles.front();
+        }
+        return true;
+    }
+
+    void startFromSnapshot(const char* path) {
+        if (loadSnapshot(path)) currentMode = GameMode::SCREENSAVER;
+    }
 
     void initECSGame() {
         constexpr float pw = 100.0f, ph = 20.0f; // paddle width/height
          paddle = createPaddle(ecsWorld, screenW() / 2.0f - pw / 2.0f, screenH() - ph - 20.0f, pw, ph); // centered at bottom
          if (auto* p = ecsWorld.getComponent<Paddle>(paddle)) p->speed = 550.0f;
 
-        const float bs = 20.0f; // ball size
-        constexpr int ballCount = 5;
-        for (int i = 0; i < ballCount; ++i) {
-            // random angle between 20 and 60 degrees
-            const float angle = randFloat(20.0f * static_cast<float>(M_PI) / 180.0f,
-                                          60.0f * static_cast<float>(M_PI) / 180.0f);
-            constexpr float speed = 500.0f;
-            // spawn balls in a vertical line in the center
-            const float bx = screenW() / 2.0f - bs / 2.0f; // centered horizontally
-            const float by = screenH() / 2.0f - bs / 2.0f + static_cast<float>(i) * 5.0f;
-            createBall(ecsWorld, bx, by, std::cos(angle) * speed, std::sin(angle) * speed, bs);
-        }
+        paddleHits = 0;
+        spawnBalls(5);
+    }
+
+    // balls start in a vertical line in the center, heading down-right; created in one batch
+    void spawnBalls(const size_t count) {
+        ecsWorld.createEntitiesWith<Transform, Renderable, Ball>(count,
+            [this](EntityID, Span<Transform> transforms, Span<Renderable>, Span<Ball>) {
+                constexpr float bs = BALL_SIZE;
+                for (size_t i = 0; i < transforms.size(); ++i) {
+                    // random angle between 20 and 60 degrees
+                    const float angle = randFloat(20.0f * static_cast<float>(M_PI) / 180.0f,
+                                                  60.0f * static_cast<float>(M_PI) / 180.0f);
+                    constexpr float speed = 500.0f;
+                    const float bx = screenW() / 2.0f - bs / 2.0f; // centered horizontally
+                    const float by = screenH() / 2.0f - bs / 2.0f + static_cast<float>(i % 64) * 5.0f;
+                    transforms[i] = Transform(bx, by, std::cos(angle) * speed, std::sin(angle) * speed, bs, bs);
+                }
+            });
+    }
+
+    void doubleBalls() {
+        const auto* balls = ecsWorld.getComponentArray<Ball>();
+        const size_t current = balls ? balls->size() : 0;
+        spawnBalls(std::min<size_t>(MAX_BALLS, current * 2) - std::min<size_t>(MAX_BALLS, current));
+    }
+
+    void halveBalls() {
+        const auto* balls = ecsWorld.getComponentArray<Ball>();
+        if (!balls || balls->size() <= 1) return;
+        // destroying while walking the pool would reorder it, so defer to a command buffer
+        CommandBuffer commands(ecsWorld);
+        for (size_t i = balls->size() / 2; i < balls->size(); ++i) commands.destroy(balls->getEntityAt(i));
+        commands.apply();
     }
 
 protected:
     void onUpdate(const float dt) override {
+        setIdle(currentMode == GameMode::MENU); // the menu is static, let the engine throttle it
+        updateSnapshotKeys();
         if (currentMode == GameMode::MENU) { updateMenu(); return; }
         if (currentMode == GameMode::SCREENSAVER) updateScreensaver(dt);
+        else if (currentMode == GameMode::ECS_SCREENSAVER) updateECSScreensaver(dt);
         else updateECSGame(dt);
     }
 
@@ -78,9 +223,23 @@ protected:
         const InputState& input = getInput();
         const bool keyOne = input.keys.count(SDLK_1) && input.keys.at(SDLK_1);
         const bool keyTwo = input.keys.count(SDLK_2) && input.keys.at(SDLK_2);
+        const bool keyThree = input.keys.count(SDLK_3) && input.keys.at(SDLK_3);
         if (keyOne && !onePressed) { currentMode = GameMode::SCREENSAVER; initScreensaver(); }
         if (keyTwo && !twoPressed) { currentMode = GameMode::ECS_DEMO; initECSGame(); }
-        onePressed = keyOne; twoPressed = keyTwo;
+        if (keyThree && !threePressed) {
+            currentMode = GameMode::ECS_SCREENSAVER;
+            initECSScreensaver(1000 * static_cast<size_t>(worldScale * worldScale));
+        }
+        onePressed = keyOne; twoPressed = keyTwo; threePressed = keyThree;
+    }
+
+    void updateSnapshotKeys() {
+        const InputState& input = getInput();
+        const bool keySave = input.keys.count(SDLK_F5) && input.keys.at(SDLK_F5); // checkpoint
+        const bool keyLoad = input.keys.count(SDLK_F9) && input.keys.at(SDLK_F9); // restore
+        if (keySave && !savePressed) saveSnapshot(SNAPSHOT_PATH);
+        if (keyLoad && !loadPressed) loadSnapshot(SNAPSHOT_PATH);
+        savePressed = keySave; loadPressed = keyLoad;
     }
 
     void updateScreensaver(const float dt) {
@@ -88,75 +247,113 @@ protected:
         const InputState& input = getInput();
         const bool keyUp = input.keys.count(SDLK_UP) && input.keys.at(SDLK_UP); // double particles
         const bool keyDown = input.keys.count(SDLK_DOWN) && input.keys.at(SDLK_DOWN); // halve particles
-        if (keyUp && !upPressed) { manager.doubleSprites(MAX_SPRITES); }
-        if (keyDown && !downPressed) { manager.halveSprites(); if (manager.getCount() == 0) spawnRandom(manager, 1); }
-        upPressed = keyUp; downPressed = keyDown;
+        if ((keyUp && !upPressed) || (keyDown && !downPressed)) {
+            PhaseTimer::Scope scope(&particleTimer, PhaseTimer::Spawn);
+            if (keyUp && !upPressed) { manager.doubleSprites(MAX_SPRITES); }
+            if (keyDown && !downPressed) { manager.halveSprites(); if (manager.getCount() == 0) spawnRandom(manager, 1); }
+        }
+        const bool keyCompact = input.keys.count(SDLK_C) && input.keys.at(SDLK_C); // toggle int16 storage
+        if (keyCompact && !compactPressed) manager.setCompact(!manager.isCompact());
+        const bool keyGovernor = input.keys.count(SDLK_G) && input.keys.at(SDLK_G); // toggle adaptive LOD
+        if (keyGovernor && !governorPressed) setGoverned(!governed);
+        upPressed = keyUp; downPressed = keyDown; compactPressed = keyCompact; governorPressed = keyGovernor;
+        updateGovernor();
+        updateCamera(dt, static_cast<float>(manager.world_width), static_cast<float>(manager.world_height));
+
+        manager.setActiveRegion(camera, farInterval);
         manager.update(dt);
     }
 
+    // WASD pans the camera over a screensaver world of the given size
+    void updateCamera(const float dt, const float worldW, const float worldH) {
+        const InputState& input = getInput();
+        float panX = 0.0f, panY = 0.0f;
+        if (input.keys.count(SDLK_A) && input.keys.at(SDLK_A)) panX -= CAMERA_SPEED * dt;
+        if (input.keys.count(SDLK_D) && input.keys.at(SDLK_D)) panX += CAMERA_SPEED * dt;
+        if (input.keys.count(SDLK_W) && input.keys.at(SDLK_W)) panY -= CAMERA_SPEED * dt;
+        if (input.keys.count(SDLK_S) && input.keys.at(SDLK_S)) panY += CAMERA_SPEED * dt;
+        camera.pan(panX, panY);
+        camera.clampTo(worldW, worldH);
+    }
+
+    // same controls and workload as the screensaver, on ECS entities
+    void updateECSScreensaver(const float dt) {
+        setMonitoredParticleCount(screensaverSystem.getCount(screensaverWorld));
+        const InputState& input = getInput();
+        const bool keyUp = input.keys.count(SDLK_UP) && input.keys.at(SDLK_UP); // double entities
+        const bool keyDown = input.keys.count(SDLK_DOWN) && input.keys.at(SDLK_DOWN); // halve entities
+        if (keyUp && !upPressed) screensaverSystem.doubleEntities(screensaverWorld, MAX_SPRITES, 0);
+        if (keyDown && !downPressed) {
+            screensaverSystem.halveEntities(screensaverWorld);
+            if (screensaverSystem.getCount(screensaverWorld) == 0) screensaverSystem.spawn(screensaverWorld, 1, 0);
+        }
+        upPressed = keyUp; downPressed = keyDown;
+        updateCamera(dt, screensaverSystem.getConfig().worldW, screensaverSystem.getConfig().worldH);
+        screensaverSystem.update(screensaverWorld, dt);
+    }
+
     void updateECSGame(const float dt) {
         // for performance monitor
-        const size_t entityCount = ecsWorld.getEntitiesWith<Transform>().size();
-        setMonitoredParticleCount(entityCount);
+        const auto* transforms = ecsWorld.getComponentArray<Transform>();
+        setMonitoredParticleCount(transforms ? transforms->size() : 0);
 
-        // input to move paddle
-        if (auto* pt = ecsWorld.getComponent<Transform>(paddle)) {
+        const InputState& input = getInput();
+        const bool keyUp = input.keys.count(SDLK_UP) && input.keys.at(SDLK_UP); // double balls
+        const bool keyDown = input.keys.count(SDLK_DOWN) && input.keys.at(SDLK_DOWN); // halve balls
+        if (keyUp && !upPressed) doubleBalls();
+        if (keyDown && !downPressed) halveBalls();
+        upPressed = keyUp; downPressed = keyDown;
+
+        // input to move paddle; only written when the velocity actually changes (change detection)
+        if (const auto* pt = ecsWorld.readComponent<Transform>(paddle)) {
             float vx = 0.0f;
-            if (const auto* p = ecsWorld.getComponent<Paddle>(paddle)) {
-                const InputState& input = getInput();
+            if (const auto* p = ecsWorld.readComponent<Paddle>(paddle)) {
                 if (input.keys.count(SDLK_A) && input.keys.at(SDLK_A)) vx = -p->speed;
                 if (input.keys.count(SDLK_D) && input.keys.at(SDLK_D)) vx = p->speed;
             }
-            pt->vx = vx; // set horizontal velocity
-        }
-
-        // move entities based on velocity
-        for (const auto entity : ecsWorld.getEntitiesWith<Transform>()) {
-            if (auto* t = ecsWorld.getComponent<Transform>(entity)) {
-                t->x += t->vx * dt; // horizontal movement
-                t->y += t->vy * dt; // vertical movement
-                if (entity == paddle) {
-                    t->x = std::max(0.0f, std::min(t->x, screenW() - t->w)); // make sure paddle stays on screen
-                }
-            }
+            if (pt->vx != vx) ecsWorld.getComponent<Transform>(paddle)->vx = vx; // set horizontal velocity
         }
 
-        // ball bounds
-        for (const auto ent : ecsWorld.getEntitiesWith<Ball>()) {
-            if (auto* bt = ecsWorld.getComponent<Transform>(ent)) {
-                // vertical bounds bounce
-                if (bt->y <= 0.0f) { bt->y = 0.0f; bt->vy = std::fabs(bt->vy); } // top
-                if (bt->y + bt->h >= screenH()) { bt->y = screenH() - bt->h; bt->vy = -std::fabs(bt->vy); } // bottom
-
-                // horizontal bounds bounce
-                if (bt->x <= 0.0f) { bt->x = 0.0f; bt->vx = std::fabs(bt->vx); } // left
-                if (bt->x + bt->w >= screenW()) { bt->x = screenW() - bt->w; bt->vx = -std::fabs(bt->vx); } // right
-            }
-        }
+        // integration, bounds, broadphase and ball/paddle collisions
+        physics.update(ecsWorld, dt, screenW(), screenH());
 
-        // Ball vs paddle AABB
-        if (const auto* pt = ecsWorld.getComponent<Transform>(paddle)) {
-            for (const auto ent : ecsWorld.getEntitiesWith<Ball>()) {
-                if (auto* bt = ecsWorld.getComponent<Transform>(ent)) {
-                    const bool hit = pt->x < bt->x + bt->w && pt->x + pt->w > bt->x &&
-                                     pt->y < bt->y + bt->h && pt->y + pt->h > bt->y; // AABB check (axis-aligned bounding box)
-                    if (hit) {
-                        bt->y = pt->y - bt->h; // place ball above paddle
-                        bt->vy = -std::fabs(bt->vy); // reflect upward
-                        bt->vx += pt->vx * 0.25f; // spin for paddle motion
-                    }
-                }
-            }
-        }
+        // gameplay reacts to this frame's contacts in one linear pass
+        const ContactStream& contacts = physics.getContacts();
+        const EntityID* hitPaddle = contacts.secondIndices();
+        for (size_t i = contacts.laneBegin(PhysicsSystem::PaddleContacts); i < contacts.laneEnd(PhysicsSystem::PaddleContacts); ++i)
+            paddleHits += hitPaddle[i] == paddle;
+        char status[96];
+        snprintf(status, sizeof(status), "Paddle hits: %zu | contacts: %zu", paddleHits, contacts.size());
+        setOverlayStatus(status);
     }
 
     void onRender() override {
         if (currentMode == GameMode::MENU) { renderMenu(); return; }
         SDL_Texture* const tex = getTexture(0);
         if (!tex) return;
-        if (currentMode == GameMode::SCREENSAVER)
-            manager.render(getRenderer(), tex);
-        else renderECS(tex);
+        if (currentMode == GameMode::SCREENSAVER) {
+            manager.render(getRenderer(), tex, camera);
+            showPhases(particleTimer, "SoA", &particleContacts);
+        } else if (currentMode == GameMode::ECS_SCREENSAVER) {
+            screensaverSystem.render(screensaverWorld, getRenderer(), textures, camera);
+            showPhases(ecsTimer, "ECS");
+        } else renderECS(tex);
+    }
+
+    // closes the frame's phase timings and shows them unless the governor owns the status line
+    void showPhases(PhaseTimer& timer, const char* label, const ContactStream* contacts = nullptr) {
+        timer.endFrame();
+        if (governed && currentMode == GameMode::SCREENSAVER) return;
+        char phases[96], status[128];
+        timer.describe(phases, sizeof(phases));
+        if (contacts) snprintf(status, sizeof(status), "%s %s | hits %zu", label, phases, contacts->size());
+        else snprintf(status, sizeof(status), "%s %s", label, phases);
+        setOverlayStatus(status);
+    }
+
+    void onSummary() override {
+        particleTimer.print("Particles (SoA)");
+        ecsTimer.print("ECS screensaver");
     }
 
     void renderMenu() const {
@@ -174,12 +371,14 @@ protected:
         const float cx = screenW() / 2.0f;
         const float cy = screenH() / 2.0f;
         renderText("DraganBall", static_cast<int>(cx), 100, white, true);
-        renderText("Select Mode:", static_cast<int>(cx), 200, yellow, true);
-        renderButton(cx, cy - 100.0f, "[1] SCREENSAVER", "UP/DOWN to add/remove particles", "",
+        renderText("Select Mode:", static_cast<int>(cx), 180, yellow, true);
+        renderButton(cx, cy - 130.0f, "[1] SCREENSAVER", "UP/DOWN to add/remove particles, WASD to pan", "C: compact int16 storage | G: adaptive LOD",
                      50, 100, 200, 100, 150, 255, white);
-        renderButton(cx, cy + 50.0f, "[2] DRAGANBALL PONG", "W/S to move paddle", "",
+        renderButton(cx, cy, "[2] DRAGANBALL PONG", "A/D to move paddle", "UP/DOWN to add/remove balls",
                      200, 50, 100, 255, 100, 150, white);
-        renderText("Press 1 or 2 to select | ESC to quit",
+        renderButton(cx, cy + 130.0f, "[3] ECS SCREENSAVER", "Screensaver workload on ECS entities", "UP/DOWN to add/remove, WASD to pan",
+                     50, 150, 80, 100, 255, 150, white);
+        renderText("Press 1, 2 or 3 to select | ESC to quit",
                    static_cast<int>(cx), static_cast<int>(screenH()) - 50, yellow, true);
     }
 
@@ -218,24 +417,101 @@ protected:
     void renderECS(SDL_Texture* tex) {
         if (!tex) return;
         // paddle
-        if (const auto* pt = ecsWorld.getComponent<Transform>(paddle)) {
+        if (const auto* pt = ecsWorld.readComponent<Transform>(paddle)) {
             SDL_SetRenderDrawColor(getRenderer(), 255, 255, 255, 255); // white paddle
             const SDL_FRect r{pt->x, pt->y, pt->w, pt->h};
             SDL_RenderFillRect(getRenderer(), &r);
         }
-        // balls
-        for (const auto ent : ecsWorld.getEntitiesWith<Ball>()) {
-            if (const auto* t = ecsWorld.getComponent<Transform>(ent)) {
-                SDL_FRect dst{t->x, t->y, t->w, t->h};
-                SDL_RenderTexture(getRenderer(), tex, nullptr, &dst);
+        // balls (every other Transform), in dense pool order
+        if (const auto* transforms = ecsWorld.getComponentArray<Transform>()) {
+            const size_t count = transforms->size();
+            const bool rebuild = transforms->getVersion() != ecsRectsVersion;
+            ecsRects.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                if (!rebuild && !transforms->changedSince(i, ecsSeenTick)) continue; // resting entity
+                const Transform& t = *transforms->getComponentAt(i);
+                ecsRects[i] = SDL_FRect{t.x, t.y, t.w, t.h};
+            }
+            ecsRectsVersion = transforms->getVersion();
+
+            const EntityID* owners = transforms->entities();
+            for (size_t i = 0; i < count; ++i) {
+                if (owners[i] == paddle) continue;
+                SDL_RenderTexture(getRenderer(), tex, nullptr, &ecsRects[i]);
             }
         }
+        ecsSeenTick = ecsWorld.markSeen(); // writes from here on are newer than ecsSeenTick
     }
 };
 
-int main() {
-    Game app(SCREEN_WIDTH, SCREEN_HEIGHT);
+static void printUsage(const char* exe) {
+    std::cout << "Usage: " << exe << " [options]\n"
+              << "  --snapshot <file>    start the screensaver from a snapshot\n"
+              << "  --record <file>      record input and frame times\n"
+              << "  --replay <file>      replay a recording and print a frame-time summary\n"
+              << "  --fixed-step <hz>    replay/benchmark timestep (default 60, 0 = recorded dt)\n"
+              << "  --bench <mode> <n>   run the screensaver workload with n entities and print a summary;\n"
+              << "                       mode is 'particles' (SoA) or 'ecs'\n"
+              << "  --bench-frames <n>   frames per benchmark run (default 600)\n"
+              << "  --headless           use SDL's dummy video driver (no window)\n"
+              << "  --compact            store screensaver particles as int16 fixed point\n"
+              << "  --huge-pages         back particle chunks with 2 MiB huge pages (Linux)\n"
+              << "  --world-scale <n>    screensaver world is n x n screens (1-16, default 1)\n"
+              << "  --far-rate <n>       simulate off-screen particles every n frames (default 1)\n"
+              << "  --budget <ms>        adapt screensaver LOD to hold this frame time\n"
+              << "  --fps <n>            cap the frame rate (sleep, then spin; default uncapped)\n"
+              << "  --vsync              present in sync with the display\n";
+}
+
+int main(int argc, char** argv) {
+    const char* snapshotPath = nullptr;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    float replayHz = 60.0f;
+    bool headless = false;
+    bool compact = false;
+    int worldScale = 1;
+    int farInterval = 1;
+    float budgetMs = 0.0f;
+    float targetFps = 0.0f;
+    bool vsync = false;
+    const char* benchMode = nullptr;
+    size_t benchCount = 0;
+    size_t benchFrames = 600;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) snapshotPath = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayPath = argv[++i];
+        else if (strcmp(argv[i], "--fixed-step") == 0 && i + 1 < argc) replayHz = std::strtof(argv[++i], nullptr);
+        else if (strcmp(argv[i], "--headless") == 0) headless = true;
+        else if (strcmp(argv[i], "--bench") == 0 && i + 2 < argc) { benchMode = argv[++i]; benchCount = std::strtoull(argv[++i], nullptr, 10); }
+        else if (strcmp(argv[i], "--bench-frames") == 0 && i + 1 < argc) benchFrames = std::strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--compact") == 0) compact = true;
+        else if (strcmp(argv[i], "--huge-pages") == 0) ChunkStorage::setHugePages(true);
+        else if (strcmp(argv[i], "--world-scale") == 0 && i + 1 < argc) worldScale = std::max(1, std::min(16, atoi(argv[++i])));
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) targetFps = std::strtof(argv[++i], nullptr);
+        else if (strcmp(argv[i], "--vsync") == 0) vsync = true;
+        else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) budgetMs = std::strtof(argv[++i], nullptr);
+        else if (strcmp(argv[i], "--far-rate") == 0 && i + 1 < argc) farInterval = std::max(1, atoi(argv[++i]));
+        else { printUsage(argv[0]); return 1; }
+    }
+    if (benchMode && strcmp(benchMode, "particles") != 0 && strcmp(benchMode, "ecs") != 0) { printUsage(argv[0]); return 1; }
+    if (headless) SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy"); // must be set before SDL_Init
+
+    Game app(SCREEN_WIDTH, SCREEN_HEIGHT, worldScale);
     if (!app.setup()) { std::cerr << "Setup failed\n"; return 1; }
+    app.setCompactParticles(compact);
+    app.setFarInterval(farInterval);
+    if (budgetMs > 0.0f) app.setFrameBudget(budgetMs);
+    app.setTargetFps(targetFps);
+    if (vsync) app.setVSync(true);
+    if (replayPath && !app.startReplay(replayPath, replayHz > 0.0f ? 1.0f / replayHz : 0.0f)) return 1;
+    if (recordPath && !replayPath && !app.startRecording(recordPath)) return 1;
+    if (snapshotPath) app.startFromSnapshot(snapshotPath);
+    if (benchMode && !replayPath) {
+        if (!app.startBenchmark(benchFrames, replayHz > 0.0f ? 1.0f / replayHz : 0.0f)) return 1;
+        app.benchmarkScreensaver(strcmp(benchMode, "ecs") == 0 ? GameMode::ECS_SCREENSAVER : GameMode::SCREENSAVER, benchCount);
+    }
     app.loop();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,81 @@
+// Changed<T>/Added<T> queries must return exactly the entities written or added since the
+// tick a system stored with markSeen(), and reads must not count as writes.
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "../lib/ECS.h"
+
+struct Position {
+    float x, y;
+};
+
+// derives from the Component base, whose name must not make it look like a filter
+struct Health : Component {
+    int points = 100;
+};
+static_assert(!is_filter<Health>::value && !is_filter<Position>::value, "plain components are not filters");
+static_assert(is_filter<Changed<Health>>::value && is_filter<Added<Health>>::value, "filters are detected");
+
+static bool ok = true;
+
+static void expect(const char* what, std::vector<EntityID> got, std::vector<EntityID> want) {
+    std::sort(got.begin(), got.end());
+    std::sort(want.begin(), want.end());
+    const bool pass = got == want;
+    printf("%s: %zu entities %s\n", what, got.size(), pass ? "ok" : "FAIL");
+    ok = ok && pass;
+}
+
+int main() {
+    ECSWorld world;
+    std::vector<EntityID> ids;
+    for (int i = 0; i < 8; ++i) {
+        ids.push_back(world.createEntity());
+        world.addComponent<Position>(ids.back(), Position{static_cast<float>(i), 0.0f});
+    }
+
+    uint32_t seen = world.markSeen();
+    expect("nothing since markSeen", world.getEntitiesWith<Changed<Position>>(seen), {});
+
+    // reads are not writes
+    for (const EntityID e : ids)
+        world.readComponent<Position>(e);
+    if (const auto* pool = world.getComponentArray<Position>())
+        pool->data();
+    expect("reads only", world.getEntitiesWith<Changed<Position>>(seen), {});
+
+    world.getComponent<Position>(ids[1])->x = 10.0f;
+    world.getComponent<Position>(ids[5])->y = 3.0f;
+    const EntityID added = world.createEntity();
+    world.addComponent<Position>(added, Position{});
+    expect("changed = written + added", world.getEntitiesWith<Changed<Position>>(seen), {ids[1], ids[5], added});
+    expect("added", world.getEntitiesWith<Added<Position>>(seen), {added});
+
+    // a system that writes through the raw pool marks only what it touched
+    seen = world.markSeen();
+    auto* pool = world.getComponentArray<Position>();
+    const size_t index = pool->indexOf(ids[3]);
+    pool->dataUntracked()[index].x += 1.0f;
+    pool->markChanged(index);
+    expect("untracked + markChanged", world.getEntitiesWith<Changed<Position>>(seen), {ids[3]});
+
+    // swap-remove moves the last element's ticks along with it
+    world.getComponent<Position>(added)->x = 1.0f; // last in the pool
+    world.removeComponent<Position>(ids[0]);
+    expect("after swap-remove", world.getEntitiesWith<Changed<Position>>(seen), {ids[3], added});
+    expect("no adds after swap-remove", world.getEntitiesWith<Added<Position>>(seen), {});
+
+    seen = world.markSeen();
+    expect("second markSeen", world.getEntitiesWith<Changed<Position>>(seen), {});
+
+    // same queries on a polymorphic pool
+    world.addComponent<Health>(ids[2], Health{});
+    world.addComponent<Health>(ids[4], Health{});
+    seen = world.markSeen();
+    world.getComponent<Health>(ids[4])->points -= 10;
+    expect("polymorphic changed", world.getEntitiesWith<Changed<Health>>(seen), {ids[4]});
+    expect("polymorphic added", world.getEntitiesWith<Added<Health>>(seen), {});
+
+    return ok ? 0 : 1;
+}
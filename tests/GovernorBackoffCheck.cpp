@@ -0,0 +1,59 @@
+// A few transient spikes must not keep the FrameGovernor from raising quality for the
+// rest of the session: the retry backoff they build up decays after a sustained run of
+// frames within budget.
+
+#include <cstdio>
+#include <cstring>
+#include "../lib/FrameGovernor.h"
+
+static bool ok = true;
+
+static void expect(const char* what, const bool pass) {
+    printf("%s: %s\n", what, pass ? "ok" : "FAIL");
+    ok = ok && pass;
+}
+
+// feeds busy time until the level changes; frames it took, or -1 if it did not within limit
+static int runUntilChange(FrameGovernor& governor, PerformanceMonitor& pm, const float ms, const int limit) {
+    pm.smoothed_busy_ms = ms;
+    for (int f = 1; f <= limit; ++f) {
+        if (governor.update(pm))
+            return f;
+    }
+    return -1;
+}
+
+int main() {
+    FrameGovernor::Config config;
+    config.targetMs = 10.0f;
+    config.settleFrames = 30;
+    config.recoverFrames = 600;
+    FrameGovernor governor(config);
+    PerformanceMonitor pm;
+    memset(&pm, 0, sizeof(pm));
+
+    const int level = governor.getLevel();
+    constexpr float kSpike = 20.0f, kFast = 5.0f, kOnBudget = 9.5f; // 9.5: within budget, no step up
+
+    // transient spikes: down, and back up once the retry delay has passed
+    int lastUp = 0;
+    for (int spike = 0; spike < 5; ++spike) {
+        runUntilChange(governor, pm, kSpike, 1000);
+        lastUp = runUntilChange(governor, pm, kFast, 100000);
+    }
+    // the waits themselves are calm, so the backoff levels off instead of hitting the cap
+    expect("backoff grew with the spikes", governor.getBackoff(level) > 2 && governor.getLevel() == level);
+    printf("  retry after the last spike: %d frames\n", lastUp);
+
+    // a long calm stretch
+    for (int f = 0; f < config.recoverFrames * 6; ++f)
+        runUntilChange(governor, pm, kOnBudget, 1);
+    expect("backoff decayed after sustained budget", governor.getBackoff(level) == 1);
+
+    runUntilChange(governor, pm, kSpike, 1000);
+    const int retry = runUntilChange(governor, pm, kFast, 100000);
+    printf("  retry after a spike past the calm stretch: %d frames\n", retry);
+    expect("quality is raised again promptly", retry > 0 && retry < lastUp && retry <= config.settleFrames * 4 + config.settleFrames);
+
+    return ok ? 0 : 1;
+}
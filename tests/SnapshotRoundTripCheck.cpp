@@ -0,0 +1,106 @@
+// Saving over the snapshot a game was loaded from must work: the loaded columns and pools
+// are adopted straight from the mapping of that file, and keep being read while it is
+// rewritten. Loading restores the grid cell size and rejects pools whose entity ids do
+// not belong to the saved world.
+
+#include <cstdio>
+#include <vector>
+#include "../lib/Entity.h"
+#include "../lib/Snapshot.h"
+
+static const char* const kPath = "roundtrip_check.dod";
+
+static bool ok = true;
+
+static void expect(const char* what, const bool pass) {
+    printf("%s: %s\n", what, pass ? "ok" : "FAIL");
+    ok = ok && pass;
+}
+
+static bool save(Particles& particles, ECSWorld& world, const char* path) {
+    SnapshotWriter writer;
+    writer.addParticles(particles);
+    writer.addWorld(world);
+    writer.addComponentPool<Transform>(world, "Transform");
+    writer.addComponentPool<Ball>(world, "Ball");
+    return writer.write(path);
+}
+
+static bool load(Particles& particles, ECSWorld& world, const char* path) {
+    SnapshotReader reader;
+    return reader.open(path) && reader.loadParticles(particles) && reader.loadWorld(world) &&
+           reader.loadComponentPool<Transform>(world, "Transform") && reader.loadComponentPool<Ball>(world, "Ball");
+}
+
+// every particle and ball position, in pool order
+static std::vector<float> state(Particles& particles, ECSWorld& world) {
+    std::vector<float> values;
+    for (size_t i = 0; i < particles.getCount(); ++i) {
+        values.push_back(particles.x[i]);
+        values.push_back(particles.vy[i]);
+    }
+    if (const auto* transforms = world.getComponentArray<Transform>()) {
+        for (size_t i = 0; i < transforms->size(); ++i)
+            values.push_back(transforms->getComponentAt(i)->x);
+    }
+    return values;
+}
+
+int main() {
+    Particles particles(1280, 720, 64, 32.0f, 32.0f);
+    ECSWorld world;
+    // enough data that columns span several pages of the mapping
+    for (int i = 0; i < 20000; ++i) {
+        particles.addSprite(static_cast<float>(i % 1200), static_cast<float>(i % 700), 1.0f, -static_cast<float>(i % 50));
+        const EntityID e = world.createEntity();
+        world.addComponent<Transform>(e, Transform(static_cast<float>(i), 0.0f));
+        world.addComponent<Ball>(e, Ball{});
+    }
+    const std::vector<float> original = state(particles, world);
+
+    expect("first save", save(particles, world, kPath));
+    expect("load", load(particles, world, kPath));
+    expect("loaded state", state(particles, world) == original);
+
+    // the adopted columns still point into the mapping of kPath
+    expect("save over the loaded file", save(particles, world, kPath));
+    expect("adopted state after save", state(particles, world) == original);
+
+    Particles reloaded(1280, 720, 64, 32.0f, 32.0f);
+    ECSWorld reloadedWorld;
+    expect("read back", load(reloaded, reloadedWorld, kPath));
+    expect("read back state", state(reloaded, reloadedWorld) == original);
+
+    // a snapshot taken with another cell size restores it
+    Particles coarse(1280, 720, 48, 32.0f, 32.0f);
+    coarse.addSprite(10.0f, 10.0f, 1.0f, 1.0f);
+    ECSWorld empty;
+    expect("save cell size 48", save(coarse, empty, kPath));
+    expect("load cell size 48", load(reloaded, reloadedWorld, kPath) && reloaded.cell_size == 48 &&
+                                reloaded.grid_w == (1280 + 47) / 48);
+
+    // ids at or past the saved nextEntityID
+    world.setNextEntityID(2);
+    expect("save stale world", save(particles, world, kPath));
+    expect("reject ids past nextEntityID", !load(reloaded, reloadedWorld, kPath));
+
+    // the same entity twice
+    {
+        const EntityID ids[2] = {1, 1};
+        const Ball balls[2] = {};
+        ECSWorld small;
+        small.setNextEntityID(2);
+        SnapshotWriter writer;
+        writer.addParticles(coarse);
+        writer.addWorld(small);
+        writer.addBlob("pool.Ball.entities", ids, sizeof(EntityID), 2);
+        writer.addBlob("pool.Ball.data", balls, sizeof(Ball), 2);
+        expect("save duplicate ids", writer.write(kPath));
+        SnapshotReader reader;
+        expect("reject duplicate ids", reader.open(kPath) && reader.loadWorld(reloadedWorld) &&
+                                       !reader.loadComponentPool<Ball>(reloadedWorld, "Ball"));
+    }
+
+    std::remove(kPath);
+    return ok ? 0 : 1;
+}